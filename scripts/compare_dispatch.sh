@@ -0,0 +1,41 @@
+#!/bin/bash
+# Direct vs. function-pointer dispatch of the benchmark hot loop. Build with
+# 'make lto' first so the direct drivers can inline the operations.
+# Usage: ./scripts/compare_dispatch.sh [threads] [repetitions]
+OUTPUT_DIR="results"
+TIMESTAMP=$(date +%Y%m%d_%H%M%S)
+RESULTS_FILE="${OUTPUT_DIR}/dispatch_${TIMESTAMP}.csv"
+mkdir -p ${OUTPUT_DIR}
+
+THREADS=${1:-1}
+REPS=${2:-5}
+OPS=2000000
+KEY_RANGE=10000
+INITIAL_SIZE=5000
+IMPLEMENTATIONS=("coarse" "fine" "lockfree")
+WORKLOADS=("readonly" "mixed")
+
+echo "impl,threads,workload,ops,key_range,time,throughput,successful,failed,dispatch" > ${RESULTS_FILE}
+
+for impl in "${IMPLEMENTATIONS[@]}"; do
+    for workload in "${WORKLOADS[@]}"; do
+        for rep in $(seq 1 $REPS); do
+            # Alternate the modes so drift (thermal, frequency) hits both equally
+            for dispatch in indirect direct; do
+                ./bin/benchmark --impl $impl --threads $THREADS --workload $workload \
+                    --ops $OPS --key-range $KEY_RANGE --initial-size $INITIAL_SIZE \
+                    --dispatch $dispatch --csv | tail -1 >> ${RESULTS_FILE}
+            done
+        done
+        awk -F, -v impl=$impl -v wl=$workload '
+            $1 == impl && $3 == wl { sum[$10] += $7; n[$10]++ }
+            END {
+                d = sum["direct"] / n["direct"]; i = sum["indirect"] / n["indirect"]
+                printf "%-9s %-9s direct %12.0f  indirect %12.0f ops/sec  (%+.1f%%)\n",
+                       impl, wl, d, i, 100 * (d - i) / i
+            }' ${RESULTS_FILE}
+    done
+done
+
+echo ""
+echo "Results: ${RESULTS_FILE}"
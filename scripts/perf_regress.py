@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""
+Performance regression gate for bin/benchmark
+
+  run      Run the standard benchmark matrix (repeated) and write a CSV
+  compare  Compare a candidate CSV against a stored baseline CSV
+  check    run + compare in one step
+
+Rows are matched on (impl, threads, workload, key_range). Throughput
+regresses when it drops, latency percentiles (p50_ns, p99_ns, when both
+files have them) when they rise. A change is flagged when it exceeds
+--threshold percent and, if both sides have at least two repetitions,
+Welch's t-test rejects "no change" at --alpha. Single runs (e.g. the
+results/results_*.csv of run_experiments.sh) are compared on the threshold
+alone and marked as untested. Exit status is 1 if anything regressed.
+
+Usage:
+  python3 scripts/perf_regress.py run --out results/baseline.csv
+  python3 scripts/perf_regress.py compare results/baseline.csv results/candidate.csv
+  python3 scripts/perf_regress.py check --baseline results/baseline.csv --threshold 5
+"""
+
+import argparse
+import csv
+import math
+import os
+import subprocess
+import sys
+
+KEY_COLUMNS = ('impl', 'threads', 'workload', 'key_range')
+# Metric -> True if higher is better
+METRICS = {'throughput': True, 'p50_ns': False, 'p99_ns': False}
+
+
+# ------------------------------------------------------------------------
+# Statistics (standard library only)
+# ------------------------------------------------------------------------
+def mean(xs):
+    return sum(xs) / len(xs)
+
+
+def variance(xs):
+    m = mean(xs)
+    return sum((x - m) ** 2 for x in xs) / (len(xs) - 1)
+
+
+def betacf(a, b, x):
+    """Continued fraction for the incomplete beta function (Lentz)"""
+    tiny = 1e-300
+    qab, qap, qam = a + b, a + 1.0, a - 1.0
+    c, d = 1.0, 1.0 - qab * x / qap
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 300):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((qam + m2) * (a + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > tiny else tiny)
+        c = 1.0 + aa / c
+        c = c if abs(c) > tiny else tiny
+        h *= d * c
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2))
+        d = 1.0 + aa * d
+        d = 1.0 / (d if abs(d) > tiny else tiny)
+        c = 1.0 + aa / c
+        c = c if abs(c) > tiny else tiny
+        delta = d * c
+        h *= delta
+        if abs(delta - 1.0) < 1e-12:
+            break
+    return h
+
+
+def betai(a, b, x):
+    """Regularized incomplete beta I_x(a, b)"""
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    ln_front = (math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b)
+                + a * math.log(x) + b * math.log(1.0 - x))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return math.exp(ln_front) * betacf(a, b, x) / a
+    return 1.0 - math.exp(ln_front) * betacf(b, a, 1.0 - x) / b
+
+
+def welch_t_test(xs, ys):
+    """Two-sided p-value for equal means, unequal variances"""
+    vx, vy = variance(xs) / len(xs), variance(ys) / len(ys)
+    if vx + vy == 0.0:
+        return 0.0 if mean(xs) != mean(ys) else 1.0
+    t = (mean(xs) - mean(ys)) / math.sqrt(vx + vy)
+    df = (vx + vy) ** 2 / (vx ** 2 / (len(xs) - 1) + vy ** 2 / (len(ys) - 1))
+    return betai(df / 2.0, 0.5, df / (df + t * t))
+
+
+# ------------------------------------------------------------------------
+# Running and loading
+# ------------------------------------------------------------------------
+def run_matrix(args):
+    """Runs every configuration args.reps times, interleaving repetitions"""
+    rows = []
+    header = None
+    configs = [(impl, threads, workload)
+               for impl in args.impls.split(',')
+               for threads in args.threads.split(',')
+               for workload in args.workloads.split(',')]
+    for rep in range(args.reps):
+        for impl, threads, workload in configs:
+            print(f"[{rep + 1}/{args.reps}] impl={impl} threads={threads} workload={workload}",
+                  file=sys.stderr)
+            cmd = [args.binary, '--impl', impl, '--threads', threads, '--workload', workload,
+                   '--ops', str(args.ops), '--key-range', str(args.key_range),
+                   '--initial-size', str(args.initial_size), '--per-thread', '--csv']
+            if args.lock_policy:
+                cmd += ['--lock-policy', args.lock_policy]
+            out = subprocess.run(cmd, check=True, capture_output=True, text=True).stdout
+            lines = [l for l in out.splitlines() if l.strip()]
+            header = lines[0]
+            rows.append(lines[-1])
+    with open(args.out, 'w') as f:
+        f.write(header + '\n')
+        f.write('\n'.join(rows) + '\n')
+    print(f"Wrote {len(rows)} rows to {args.out}", file=sys.stderr)
+
+
+def load(path):
+    """Groups samples per configuration: {key: {metric: [values]}}"""
+    groups = {}
+    with open(path, newline='') as f:
+        for row in csv.DictReader(f):
+            key = tuple(row[c] for c in KEY_COLUMNS)
+            group = groups.setdefault(key, {})
+            for metric in METRICS:
+                if row.get(metric):
+                    group.setdefault(metric, []).append(float(row[metric]))
+    return groups
+
+
+# ------------------------------------------------------------------------
+# Comparison
+# ------------------------------------------------------------------------
+def compare(baseline_path, candidate_path, threshold, alpha):
+    baseline, candidate = load(baseline_path), load(candidate_path)
+    common = sorted(set(baseline) & set(candidate))
+    if not common:
+        print("No configurations in common between the two files", file=sys.stderr)
+        return 2
+
+    regressions = 0
+    print(f"{'impl':<9} {'thr':>4} {'workload':<9} {'metric':<11} {'baseline':>14} "
+          f"{'candidate':>14} {'change':>8} {'p-value':>8}  verdict")
+    for key in common:
+        impl, threads, workload, _ = key
+        for metric, higher_is_better in METRICS.items():
+            xs, ys = baseline[key].get(metric), candidate[key].get(metric)
+            if not xs or not ys:
+                continue
+            base, cand = mean(xs), mean(ys)
+            if base == 0:
+                continue
+            change = 100.0 * (cand - base) / base
+            worse = -change if higher_is_better else change
+
+            tested = len(xs) >= 2 and len(ys) >= 2
+            p = welch_t_test(xs, ys) if tested else None
+            significant = p < alpha if tested else True
+
+            if worse > threshold and significant:
+                verdict = 'REGRESSION'
+                regressions += 1
+            elif -worse > threshold and significant:
+                verdict = 'improved'
+            else:
+                verdict = 'ok'
+            if not tested:
+                verdict += ' (untested, n=1)'
+
+            p_text = f"{p:.4f}" if tested else '-'
+            print(f"{impl:<9} {threads:>4} {workload:<9} {metric:<11} {base:>14.1f} "
+                  f"{cand:>14.1f} {change:>+7.1f}% {p_text:>8}  {verdict}")
+
+    only_baseline = len(set(baseline) - set(candidate))
+    if only_baseline:
+        print(f"\n{only_baseline} baseline configuration(s) have no candidate rows")
+    print(f"\n{regressions} regression(s) beyond {threshold}% (alpha {alpha})")
+    return 1 if regressions else 0
+
+
+def add_run_options(parser):
+    parser.add_argument('--binary', default='./bin/benchmark')
+    parser.add_argument('--impls', default='coarse,fine,lockfree')
+    parser.add_argument('--threads', default='1,4,8')
+    parser.add_argument('--workloads', default='mixed,readonly')
+    parser.add_argument('--ops', type=int, default=200000)
+    parser.add_argument('--key-range', type=int, default=100000)
+    parser.add_argument('--initial-size', type=int, default=5000)
+    parser.add_argument('--reps', type=int, default=5)
+    parser.add_argument('--lock-policy', choices=('park', 'spin', 'omp'),
+                        help='Coarse/fine lock (default: the benchmark default, park); '
+                             'use omp against results recorded before the futex lock')
+
+
+def add_compare_options(parser):
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help='Percent change that counts as a regression (default: 5)')
+    parser.add_argument('--alpha', type=float, default=0.05,
+                        help='Significance level of the t-test (default: 0.05)')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    run_parser = sub.add_parser('run', help='Run the benchmark matrix')
+    add_run_options(run_parser)
+    run_parser.add_argument('--out', required=True)
+
+    compare_parser = sub.add_parser('compare', help='Compare two result CSVs')
+    compare_parser.add_argument('baseline')
+    compare_parser.add_argument('candidate')
+    add_compare_options(compare_parser)
+
+    check_parser = sub.add_parser('check', help='Run the matrix and compare to a baseline')
+    add_run_options(check_parser)
+    add_compare_options(check_parser)
+    check_parser.add_argument('--baseline', required=True)
+    check_parser.add_argument('--out', default='results/candidate.csv')
+
+    args = parser.parse_args()
+    if args.command == 'run':
+        run_matrix(args)
+        return 0
+    if args.command == 'compare':
+        return compare(args.baseline, args.candidate, args.threshold, args.alpha)
+
+    os.makedirs(os.path.dirname(args.out) or '.', exist_ok=True)
+    run_matrix(args)
+    return compare(args.baseline, args.out, args.threshold, args.alpha)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+Latency vs. offered load plot for open-loop results (scripts/run_open_loop.sh)
+"""
+
+import pandas as pd
+import matplotlib.pyplot as plt
+import sys
+import os
+
+def plot_latency_vs_load(df, output_dir):
+    """p50/p99 latency (log scale) against offered load, one color per impl"""
+    fig, ax = plt.subplots(figsize=(8, 5))
+    labels = {'coarse': 'Coarse-Grained', 'fine': 'Fine-Grained', 'lockfree': 'Lock-Free'}
+
+    for impl in df['impl'].unique():
+        impl_data = df[df['impl'] == impl].sort_values('offered_rate')
+        label = labels.get(impl, impl)
+        line, = ax.plot(impl_data['offered_rate'] / 1e6, impl_data['p99_ns'] / 1e3,
+                        marker='o', linewidth=2, label=f'{label} p99')
+        ax.plot(impl_data['offered_rate'] / 1e6, impl_data['p50_ns'] / 1e3,
+                marker='s', linewidth=1, linestyle='--', color=line.get_color(),
+                label=f'{label} p50')
+
+    ax.set_xlabel('Offered Load (M ops/sec)', fontweight='bold')
+    ax.set_ylabel('Latency from intended start (us)', fontweight='bold')
+    ax.set_yscale('log')
+    ax.set_title('Latency vs. Offered Load (Open Loop)', fontweight='bold', pad=15)
+    ax.legend(frameon=True)
+    ax.grid(True, alpha=0.3, linestyle='--')
+    plt.tight_layout()
+
+    output_path = os.path.join(output_dir, 'figure_open_loop.png')
+    plt.savefig(output_path, bbox_inches='tight', dpi=300)
+    plt.close()
+    print(f"Created: {output_path}")
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python3 plot_open_loop.py <open_loop_csv>")
+        sys.exit(1)
+
+    df = pd.read_csv(sys.argv[1])
+    output_dir = 'figures'
+    os.makedirs(output_dir, exist_ok=True)
+    plot_latency_vs_load(df, output_dir)
+
+if __name__ == '__main__':
+    main()
@@ -6,6 +6,10 @@ TEMP_FILE="${OUTPUT_DIR}/temp_results.txt"
 mkdir -p ${OUTPUT_DIR}
 
 IMPLEMENTATIONS=("coarse" "fine" "lockfree")
+# --baselines adds the non-skip-list structures to the same CSV
+if [ "$1" == "--baselines" ]; then
+    IMPLEMENTATIONS+=("avl" "hash" "btree")
+fi
 THREAD_COUNTS=(1 2 4 8 16 32)
 WORKLOADS=("insert" "readonly" "mixed" "delete")
 OPS_PER_THREAD=1000000
@@ -55,24 +59,26 @@ run_benchmark() {
 }
 
 echo ""
-echo "=== Experiment 1: Scalability (18 runs) ==="
+RUNS=$(( ${#IMPLEMENTATIONS[@]} * ${#THREAD_COUNTS[@]} ))
+echo "=== Experiment 1: Scalability (${RUNS} runs) ==="
 current=0
 for impl in "${IMPLEMENTATIONS[@]}"; do
     for threads in "${THREAD_COUNTS[@]}"; do
         ((current++))
-        echo "Progress: [$current/18]"
+        echo "Progress: [$current/${RUNS}]"
         run_benchmark $impl $threads "mixed" $OPS_PER_THREAD $KEY_RANGE 5000
     done
 done
 
 echo ""
-echo "=== Experiment 2: Workload Comparison (12 runs) ==="
+RUNS=$(( ${#IMPLEMENTATIONS[@]} * ${#WORKLOADS[@]} ))
+echo "=== Experiment 2: Workload Comparison (${RUNS} runs) ==="
 FIXED_THREADS=8
 current=0
 for impl in "${IMPLEMENTATIONS[@]}"; do
     for workload in "${WORKLOADS[@]}"; do
         ((current++))
-        echo "Progress: [$current/12]"
+        echo "Progress: [$current/${RUNS}]"
         if [ "$workload" == "delete" ] || [ "$workload" == "readonly" ]; then
             run_benchmark $impl $FIXED_THREADS $workload $OPS_PER_THREAD $KEY_RANGE 50000
         else
@@ -82,14 +88,15 @@ for impl in "${IMPLEMENTATIONS[@]}"; do
 done
 
 echo ""
-echo "=== Experiment 3: Contention Study (12 runs) ==="
 FIXED_THREADS=16
 KEY_RANGES=(1000 10000 100000 1000000)
+RUNS=$(( ${#IMPLEMENTATIONS[@]} * ${#KEY_RANGES[@]} ))
+echo "=== Experiment 3: Contention Study (${RUNS} runs) ==="
 current=0
 for impl in "${IMPLEMENTATIONS[@]}"; do
     for key_range in "${KEY_RANGES[@]}"; do
         ((current++))
-        echo "Progress: [$current/12]"
+        echo "Progress: [$current/${RUNS}]"
         run_benchmark $impl $FIXED_THREADS "mixed" $OPS_PER_THREAD $key_range 5000
     done
 done
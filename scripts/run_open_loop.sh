@@ -0,0 +1,39 @@
+#!/bin/bash
+# Latency vs. offered load: runs each implementation open loop (--rate) at
+# increasing per-thread rates until it can no longer keep up.
+# Usage: ./scripts/run_open_loop.sh [threads] [seconds_per_point]
+OUTPUT_DIR="results"
+TIMESTAMP=$(date +%Y%m%d_%H%M%S)
+RESULTS_FILE="${OUTPUT_DIR}/open_loop_${TIMESTAMP}.csv"
+mkdir -p ${OUTPUT_DIR}
+
+THREADS=${1:-8}
+DURATION=${2:-5}
+KEY_RANGE=100000
+INITIAL_SIZE=50000
+IMPLEMENTATIONS=("coarse" "fine" "lockfree")
+# Per-thread rates (ops/sec)
+RATES=(10000 25000 50000 100000 250000 500000 1000000 2500000 5000000)
+
+echo "impl,threads,workload,ops,key_range,time,throughput,successful,failed,offered_rate,p50_ns,p99_ns,p999_ns,max_ns" > ${RESULTS_FILE}
+
+for impl in "${IMPLEMENTATIONS[@]}"; do
+    for rate in "${RATES[@]}"; do
+        echo "[$(date +%H:%M:%S)] impl=$impl threads=$THREADS rate=$rate/thread"
+        line=$(./bin/benchmark --impl $impl --threads $THREADS --workload mixed \
+                   --key-range $KEY_RANGE --initial-size $INITIAL_SIZE \
+                   --duration $DURATION --rate $rate --csv | tail -1)
+        echo "$line" >> ${RESULTS_FILE}
+
+        # Past saturation the queueing delay only grows; one point is enough
+        saturated=$(echo "$line" | awk -F, '{ print ($7 < 0.9 * $10) ? 1 : 0 }')
+        if [ "$saturated" == "1" ]; then
+            echo "  saturated at $(echo "$line" | cut -d, -f7) ops/sec"
+            break
+        fi
+    done
+done
+
+echo ""
+echo "Results: ${RESULTS_FILE}"
+echo "Plot with: python3 scripts/plot_open_loop.py ${RESULTS_FILE}"
@@ -0,0 +1,39 @@
+#!/bin/bash
+# Oversubscription sweep: threads from 0.5x to 4x the online cores, with the
+# coarse/fine locks parking (spin-then-futex) or spinning only. Lock-free is
+# included as the reference.
+# Usage: ./scripts/run_oversubscription.sh [seconds_per_point]
+OUTPUT_DIR="results"
+TIMESTAMP=$(date +%Y%m%d_%H%M%S)
+RESULTS_FILE="${OUTPUT_DIR}/oversubscription_${TIMESTAMP}.csv"
+mkdir -p ${OUTPUT_DIR}
+
+DURATION=${1:-5}
+KEY_RANGE=10000
+INITIAL_SIZE=5000
+FACTORS=(0.5 1 2 3 4)
+POLICIES=("park" "spin")
+
+# Idle OpenMP workers must not spin either, or they compete with the
+# benchmark threads for the oversubscribed cores
+export OMP_WAIT_POLICY=passive
+
+echo "impl,threads,workload,ops,key_range,time,throughput,successful,failed,cores,lock_policy" > ${RESULTS_FILE}
+
+for factor in "${FACTORS[@]}"; do
+    for impl in coarse fine lockfree; do
+        for policy in "${POLICIES[@]}"; do
+            # The policy only affects the lock-based variants
+            if [ "$impl" == "lockfree" ] && [ "$policy" != "park" ]; then
+                continue
+            fi
+            echo "[$(date +%H:%M:%S)] impl=$impl oversubscribe=${factor}x policy=$policy"
+            ./bin/benchmark --impl $impl --oversubscribe $factor --lock-policy $policy \
+                --workload mixed --key-range $KEY_RANGE --initial-size $INITIAL_SIZE \
+                --duration $DURATION --csv | tail -1 >> ${RESULTS_FILE}
+        done
+    done
+done
+
+echo ""
+echo "Results: ${RESULTS_FILE}"
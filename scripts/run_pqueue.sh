@@ -0,0 +1,27 @@
+#!/bin/bash
+# Priority-queue sweep: strict pop_min against the relaxed SprayList pop
+# (pqueue vs. pqueue_spray) from 1 to 32 threads, 50% inserts.
+# Usage: ./scripts/run_pqueue.sh [seconds_per_point]
+OUTPUT_DIR="results"
+TIMESTAMP=$(date +%Y%m%d_%H%M%S)
+RESULTS_FILE="${OUTPUT_DIR}/pqueue_${TIMESTAMP}.csv"
+mkdir -p ${OUTPUT_DIR}
+
+DURATION=${1:-5}
+KEY_RANGE=10000000
+INITIAL_SIZE=100000
+THREADS=(1 2 4 8 16 32)
+
+echo "impl,threads,workload,ops,key_range,time,throughput,successful,failed" > ${RESULTS_FILE}
+
+for threads in "${THREADS[@]}"; do
+    for workload in pqueue pqueue_spray; do
+        echo "[$(date +%H:%M:%S)] workload=$workload threads=$threads"
+        ./bin/benchmark --impl lockfree --workload $workload --threads $threads \
+            --key-range $KEY_RANGE --initial-size $INITIAL_SIZE \
+            --duration $DURATION --csv | tail -1 >> ${RESULTS_FILE}
+    done
+done
+
+echo ""
+echo "Results: ${RESULTS_FILE}"
@@ -0,0 +1,29 @@
+#!/bin/bash
+# Reader scaling under writer interference: fixed reader threads, increasing
+# dedicated writer threads, for each implementation.
+# Usage: ./scripts/run_reader_writer.sh [readers] [max_writers] [seconds_per_point]
+OUTPUT_DIR="results"
+TIMESTAMP=$(date +%Y%m%d_%H%M%S)
+RESULTS_FILE="${OUTPUT_DIR}/reader_writer_${TIMESTAMP}.csv"
+mkdir -p ${OUTPUT_DIR}
+
+READERS=${1:-8}
+MAX_WRITERS=${2:-4}
+DURATION=${3:-5}
+KEY_RANGE=100000
+INITIAL_SIZE=50000
+IMPLEMENTATIONS=("coarse" "fine" "lockfree")
+
+echo "impl,threads,workload,ops,key_range,time,throughput,successful,failed,readers,writers,reader_throughput,reader_p50_ns,reader_p99_ns,writer_throughput,writer_p50_ns,writer_p99_ns" > ${RESULTS_FILE}
+
+for impl in "${IMPLEMENTATIONS[@]}"; do
+    for writers in $(seq 0 $MAX_WRITERS); do
+        echo "[$(date +%H:%M:%S)] impl=$impl readers=$READERS writers=$writers"
+        ./bin/benchmark --impl $impl --readers $READERS --writers $writers \
+            --key-range $KEY_RANGE --initial-size $INITIAL_SIZE \
+            --duration $DURATION --csv | tail -1 >> ${RESULTS_FILE}
+    done
+done
+
+echo ""
+echo "Results: ${RESULTS_FILE}"
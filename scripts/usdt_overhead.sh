@@ -0,0 +1,49 @@
+#!/bin/bash
+# Measures the cost of the (unattached) USDT probes: builds the benchmark
+# with and without them and alternates runs of each, per implementation.
+# Usage: ./scripts/usdt_overhead.sh [reps] [threads] [ops_per_thread]
+REPS=${1:-10}
+THREADS=${2:-8}
+OPS=${3:-1000000}
+KEY_RANGE=100000
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf ${WORK_DIR}' EXIT
+
+IMPLEMENTATIONS=("coarse" "fine" "lockfree")
+
+echo "Building with and without USDT probes..."
+make -s BUILD_DIR=${WORK_DIR}/build_usdt BIN_DIR=${WORK_DIR}/usdt all > /dev/null || exit 1
+make -s BUILD_DIR=${WORK_DIR}/build_nousdt BIN_DIR=${WORK_DIR}/nousdt nousdt > /dev/null || exit 1
+
+if ! readelf -n ${WORK_DIR}/usdt/benchmark 2>/dev/null | grep -q stapsdt; then
+    echo "Note: <sys/sdt.h> not found at build time, both binaries are probe-free"
+fi
+
+run_once() {
+    $1 --impl $2 --threads ${THREADS} --ops ${OPS} --key-range ${KEY_RANGE} \
+       --workload mixed --initial-size 5000 --csv | tail -1 | cut -d, -f7
+}
+
+echo "impl,variant,mean_throughput,stddev,reps"
+for impl in "${IMPLEMENTATIONS[@]}"; do
+    : > ${WORK_DIR}/with.txt
+    : > ${WORK_DIR}/without.txt
+    # Alternate the two binaries so drift (thermal, frequency) hits both
+    for ((r = 0; r < REPS; r++)); do
+        run_once ${WORK_DIR}/usdt/benchmark $impl >> ${WORK_DIR}/with.txt
+        run_once ${WORK_DIR}/nousdt/benchmark $impl >> ${WORK_DIR}/without.txt
+    done
+    for variant in with without; do
+        awk -v impl=$impl -v variant=$variant '
+            { sum += $1; sumsq += $1 * $1; n++ }
+            END { mean = sum / n; sd = sqrt(sumsq / n - mean * mean);
+                  printf "%s,%s_probes,%.2f,%.2f,%d\n", impl, variant, mean, sd, n }' \
+            ${WORK_DIR}/${variant}.txt
+    done
+    paste ${WORK_DIR}/with.txt ${WORK_DIR}/without.txt | awk -v impl=$impl '
+        { w += $1; wo += $2; d = $1 - $2; sd += d; sdsq += d * d; n++ }
+        END { mean = sd / n; se = sqrt((sdsq / n - mean * mean) / n);
+              verdict = (mean < 0 ? -mean : mean) <= 2 * se ? "within noise" : "SIGNIFICANT";
+              printf "# %s: probes change throughput by %+.2f%% (+/- %.2f%%, 2 s.e.) -> %s\n",
+                     impl, 100 * mean / (wo / n), 200 * se / (wo / n), verdict }'
+done
@@ -0,0 +1,598 @@
+#include "baselines.h"
+#include "skiplist_instrument.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+static void* baseline_alloc(size_t size) {
+    void* p = calloc(1, size);
+    if (!p) {
+        perror("Failed to allocate baseline structure");
+        exit(1);
+    }
+    return p;
+}
+
+static void init_base(SkipList* base) {
+    base->head = NULL;
+    base->tail = NULL;
+    base->maxLevel = 0;
+    atomic_init(&base->size, 0);
+    skiplock_init(&base->lock);
+}
+
+// ------------------------------------------------------------------------
+// AVL tree behind one reader-writer lock
+// ------------------------------------------------------------------------
+typedef struct AvlNode {
+    int key;
+    int height;
+    struct AvlNode* left;
+    struct AvlNode* right;
+} AvlNode;
+
+typedef struct {
+    SkipList base;  // Must be first: the ops interface passes SkipList*
+    pthread_rwlock_t lock;
+    AvlNode* root;
+} AvlSet;
+
+static inline int avl_height(AvlNode* n) {
+    return n ? n->height : 0;
+}
+
+static inline void avl_update(AvlNode* n) {
+    int l = avl_height(n->left);
+    int r = avl_height(n->right);
+    n->height = 1 + (l > r ? l : r);
+}
+
+static AvlNode* avl_rotate_right(AvlNode* y) {
+    AvlNode* x = y->left;
+    y->left = x->right;
+    x->right = y;
+    avl_update(y);
+    avl_update(x);
+    return x;
+}
+
+static AvlNode* avl_rotate_left(AvlNode* x) {
+    AvlNode* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    avl_update(x);
+    avl_update(y);
+    return y;
+}
+
+static AvlNode* avl_rebalance(AvlNode* n) {
+    avl_update(n);
+    int balance = avl_height(n->left) - avl_height(n->right);
+    if (balance > 1) {
+        if (avl_height(n->left->left) < avl_height(n->left->right)) {
+            n->left = avl_rotate_left(n->left);
+        }
+        return avl_rotate_right(n);
+    }
+    if (balance < -1) {
+        if (avl_height(n->right->right) < avl_height(n->right->left)) {
+            n->right = avl_rotate_right(n->right);
+        }
+        return avl_rotate_left(n);
+    }
+    return n;
+}
+
+static AvlNode* avl_insert(AvlNode* n, int key, bool* inserted) {
+    if (!n) {
+        AvlNode* node = (AvlNode*)baseline_alloc(sizeof(AvlNode));
+        node->key = key;
+        node->height = 1;
+        *inserted = true;
+        return node;
+    }
+    if (key < n->key) {
+        n->left = avl_insert(n->left, key, inserted);
+    } else if (key > n->key) {
+        n->right = avl_insert(n->right, key, inserted);
+    } else {
+        return n;
+    }
+    return avl_rebalance(n);
+}
+
+static AvlNode* avl_remove_min(AvlNode* n, AvlNode** min) {
+    if (!n->left) {
+        *min = n;
+        return n->right;
+    }
+    n->left = avl_remove_min(n->left, min);
+    return avl_rebalance(n);
+}
+
+static AvlNode* avl_delete(AvlNode* n, int key, bool* deleted) {
+    if (!n) return NULL;
+    if (key < n->key) {
+        n->left = avl_delete(n->left, key, deleted);
+    } else if (key > n->key) {
+        n->right = avl_delete(n->right, key, deleted);
+    } else {
+        AvlNode* left = n->left;
+        AvlNode* right = n->right;
+        free(n);
+        *deleted = true;
+        if (!right) return left;
+
+        // Replace the node with its in-order successor
+        AvlNode* min;
+        right = avl_remove_min(right, &min);
+        min->left = left;
+        min->right = right;
+        return avl_rebalance(min);
+    }
+    return avl_rebalance(n);
+}
+
+static void avl_free(AvlNode* n) {
+    if (!n) return;
+    avl_free(n->left);
+    avl_free(n->right);
+    free(n);
+}
+
+SkipList* baseline_create_avl(void) {
+    AvlSet* set = (AvlSet*)baseline_alloc(sizeof(AvlSet));
+    init_base(&set->base);
+    pthread_rwlock_init(&set->lock, NULL);
+    set->root = NULL;
+    return &set->base;
+}
+
+bool baseline_insert_avl(SkipList* list, int key, int value) {
+    (void)value;
+    AvlSet* set = (AvlSet*)list;
+    bool inserted = false;
+    pthread_rwlock_wrlock(&set->lock);
+    set->root = avl_insert(set->root, key, &inserted);
+    pthread_rwlock_unlock(&set->lock);
+    if (inserted) atomic_fetch_add(&list->size, 1);
+    return inserted;
+}
+
+bool baseline_delete_avl(SkipList* list, int key) {
+    AvlSet* set = (AvlSet*)list;
+    bool deleted = false;
+    pthread_rwlock_wrlock(&set->lock);
+    set->root = avl_delete(set->root, key, &deleted);
+    pthread_rwlock_unlock(&set->lock);
+    if (deleted) atomic_fetch_sub(&list->size, 1);
+    return deleted;
+}
+
+bool baseline_contains_avl(SkipList* list, int key) {
+    AvlSet* set = (AvlSet*)list;
+    pthread_rwlock_rdlock(&set->lock);
+    AvlNode* n = set->root;
+    while (n && n->key != key) {
+        n = key < n->key ? n->left : n->right;
+    }
+    pthread_rwlock_unlock(&set->lock);
+    return n != NULL;
+}
+
+void baseline_destroy_avl(SkipList* list) {
+    AvlSet* set = (AvlSet*)list;
+    avl_free(set->root);
+    pthread_rwlock_destroy(&set->lock);
+    free(set);
+}
+
+// ------------------------------------------------------------------------
+// Lock-striped hash set (Herlihy & Shavit, StripedHashSet)
+// The bucket count is always a multiple of HASH_STRIPES, so a key maps to
+// the same stripe before and after a resize.
+// ------------------------------------------------------------------------
+#define HASH_STRIPES 64
+#define HASH_INITIAL_BUCKETS 1024
+#define HASH_MAX_LOAD 4
+
+typedef struct HashEntry {
+    int key;
+    struct HashEntry* next;
+} HashEntry;
+
+typedef struct {
+    SkipLock lock;
+} __attribute__((aligned(CACHE_LINE_SIZE))) HashStripe;
+
+typedef struct {
+    SkipList base;  // Must be first: the ops interface passes SkipList*
+    HashStripe stripes[HASH_STRIPES];
+    HashEntry** buckets;    // Read under any stripe lock, replaced under all
+    size_t capacity;
+} HashSet;
+
+// murmur3 finalizer: sequential keys spread over all buckets
+static inline uint32_t hash_key(int key) {
+    uint32_t h = (uint32_t)key;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline SkipLock* hash_stripe(HashSet* set, uint32_t h) {
+    return &set->stripes[h & (HASH_STRIPES - 1)].lock;
+}
+
+static inline HashEntry** hash_bucket(HashSet* set, uint32_t h) {
+    return &set->buckets[h & (set->capacity - 1)];
+}
+
+// Takes every stripe directly rather than through lock_acquire(): the lock
+// profile assumes a thread holds one lock at a time
+static void hash_resize(HashSet* set, size_t seen_capacity) {
+    for (int s = 0; s < HASH_STRIPES; s++) {
+        skiplock_lock(&set->stripes[s].lock);
+    }
+
+    if (set->capacity == seen_capacity) {  // Nobody resized meanwhile
+        size_t capacity = seen_capacity * 2;
+        HashEntry** buckets = (HashEntry**)baseline_alloc(capacity * sizeof(HashEntry*));
+        for (size_t b = 0; b < seen_capacity; b++) {
+            HashEntry* e = set->buckets[b];
+            while (e) {
+                HashEntry* next = e->next;
+                HashEntry** dst = &buckets[hash_key(e->key) & (capacity - 1)];
+                e->next = *dst;
+                *dst = e;
+                e = next;
+            }
+        }
+        free(set->buckets);
+        set->buckets = buckets;
+        set->capacity = capacity;
+    }
+
+    for (int s = HASH_STRIPES - 1; s >= 0; s--) {
+        skiplock_unlock(&set->stripes[s].lock);
+    }
+}
+
+SkipList* baseline_create_hash(void) {
+    HashSet* set = (HashSet*)baseline_alloc(sizeof(HashSet));
+    init_base(&set->base);
+    for (int s = 0; s < HASH_STRIPES; s++) {
+        skiplock_init(&set->stripes[s].lock);
+    }
+    set->capacity = HASH_INITIAL_BUCKETS;
+    set->buckets = (HashEntry**)baseline_alloc(set->capacity * sizeof(HashEntry*));
+    return &set->base;
+}
+
+bool baseline_insert_hash(SkipList* list, int key, int value) {
+    (void)value;
+    HashSet* set = (HashSet*)list;
+    uint32_t h = hash_key(key);
+    SkipLock* lock = hash_stripe(set, h);
+    bool inserted = true;
+
+    lock_acquire(lock);
+    HashEntry** bucket = hash_bucket(set, h);
+    for (HashEntry* e = *bucket; e; e = e->next) {
+        if (e->key == key) {
+            inserted = false;
+            break;
+        }
+    }
+    if (inserted) {
+        HashEntry* entry = (HashEntry*)baseline_alloc(sizeof(HashEntry));
+        entry->key = key;
+        entry->next = *bucket;
+        *bucket = entry;
+    }
+    size_t capacity = set->capacity;
+    lock_release(lock);
+
+    if (inserted) {
+        int size = atomic_fetch_add(&list->size, 1) + 1;
+        if ((size_t)size > capacity * HASH_MAX_LOAD) {
+            hash_resize(set, capacity);
+        }
+    }
+    return inserted;
+}
+
+bool baseline_delete_hash(SkipList* list, int key) {
+    HashSet* set = (HashSet*)list;
+    uint32_t h = hash_key(key);
+    SkipLock* lock = hash_stripe(set, h);
+    HashEntry* victim = NULL;
+
+    lock_acquire(lock);
+    for (HashEntry** link = hash_bucket(set, h); *link; link = &(*link)->next) {
+        if ((*link)->key == key) {
+            victim = *link;
+            *link = victim->next;
+            break;
+        }
+    }
+    lock_release(lock);
+
+    if (!victim) return false;
+    free(victim);
+    atomic_fetch_sub(&list->size, 1);
+    return true;
+}
+
+bool baseline_contains_hash(SkipList* list, int key) {
+    HashSet* set = (HashSet*)list;
+    uint32_t h = hash_key(key);
+    SkipLock* lock = hash_stripe(set, h);
+    bool found = false;
+
+    lock_acquire(lock);
+    for (HashEntry* e = *hash_bucket(set, h); e; e = e->next) {
+        if (e->key == key) {
+            found = true;
+            break;
+        }
+    }
+    lock_release(lock);
+    return found;
+}
+
+void baseline_destroy_hash(SkipList* list) {
+    HashSet* set = (HashSet*)list;
+    for (size_t b = 0; b < set->capacity; b++) {
+        HashEntry* e = set->buckets[b];
+        while (e) {
+            HashEntry* next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    for (int s = 0; s < HASH_STRIPES; s++) {
+        skiplock_destroy(&set->stripes[s].lock);
+    }
+    free(set->buckets);
+    free(set);
+}
+
+// ------------------------------------------------------------------------
+// B+tree with lock coupling
+// Lookups, deletes and inserts first descend with read locks and only
+// write-lock the leaf. An insert that finds its leaf full starts over and
+// splits full nodes on the way down while holding the parent's write lock,
+// so a split never propagates upwards and at most two node locks are held.
+// Deletes leave underfull (even empty) leaves behind; separators stay valid.
+// ------------------------------------------------------------------------
+#define BTREE_MAX_KEYS 31
+
+typedef struct BTreeNode {
+    pthread_rwlock_t lock;
+    bool leaf;                                      // Fixed at creation
+    int count;
+    int keys[BTREE_MAX_KEYS];
+    struct BTreeNode* children[BTREE_MAX_KEYS + 1]; // Inner nodes only
+} BTreeNode;
+
+typedef struct {
+    SkipList base;  // Must be first: the ops interface passes SkipList*
+    pthread_rwlock_t root_lock;  // Guards the root pointer (written on root splits)
+    BTreeNode* root;
+} BTreeSet;
+
+static BTreeNode* btree_node(bool leaf) {
+    BTreeNode* n = (BTreeNode*)baseline_alloc(sizeof(BTreeNode));
+    pthread_rwlock_init(&n->lock, NULL);
+    n->leaf = leaf;
+    return n;
+}
+
+// First index with keys[i] >= key
+static inline int btree_lower_bound(BTreeNode* n, int key) {
+    int lo = 0, hi = n->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (n->keys[mid] < key) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+// Child to follow: separators are the first key of their right subtree
+static inline int btree_child_index(BTreeNode* n, int key) {
+    int lo = 0, hi = n->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (n->keys[mid] <= key) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static inline void btree_lock(BTreeNode* n, bool exclusive) {
+    if (exclusive) pthread_rwlock_wrlock(&n->lock); else pthread_rwlock_rdlock(&n->lock);
+}
+
+// Splits the full child at parent->children[i]; parent (not full) and child
+// are write-locked by the caller. The new right sibling is only reachable
+// through the parent, so it needs no lock until the parent is released.
+static BTreeNode* btree_split_child(BTreeNode* parent, int i, BTreeNode* child) {
+    BTreeNode* right = btree_node(child->leaf);
+    int mid = BTREE_MAX_KEYS / 2;
+    int separator;
+
+    if (child->leaf) {
+        right->count = BTREE_MAX_KEYS - mid;
+        memcpy(right->keys, &child->keys[mid], right->count * sizeof(int));
+        child->count = mid;
+        separator = right->keys[0];
+    } else {
+        separator = child->keys[mid];
+        right->count = BTREE_MAX_KEYS - mid - 1;
+        memcpy(right->keys, &child->keys[mid + 1], right->count * sizeof(int));
+        memcpy(right->children, &child->children[mid + 1], (right->count + 1) * sizeof(BTreeNode*));
+        child->count = mid;
+    }
+
+    memmove(&parent->keys[i + 1], &parent->keys[i], (parent->count - i) * sizeof(int));
+    memmove(&parent->children[i + 2], &parent->children[i + 1], (parent->count - i) * sizeof(BTreeNode*));
+    parent->keys[i] = separator;
+    parent->children[i + 1] = right;
+    parent->count++;
+    return right;
+}
+
+// Lock-couples from the root to the leaf for key, write-locking only the
+// leaf; returns it locked
+static BTreeNode* btree_find_leaf(BTreeSet* set, int key, bool exclusive) {
+    pthread_rwlock_rdlock(&set->root_lock);
+    BTreeNode* n = set->root;
+    btree_lock(n, exclusive && n->leaf);
+    pthread_rwlock_unlock(&set->root_lock);
+
+    while (!n->leaf) {
+        BTreeNode* child = n->children[btree_child_index(n, key)];
+        btree_lock(child, exclusive && child->leaf);
+        pthread_rwlock_unlock(&n->lock);
+        n = child;
+    }
+    return n;
+}
+
+static void btree_free(BTreeNode* n) {
+    if (!n->leaf) {
+        for (int i = 0; i <= n->count; i++) {
+            btree_free(n->children[i]);
+        }
+    }
+    pthread_rwlock_destroy(&n->lock);
+    free(n);
+}
+
+SkipList* baseline_create_btree(void) {
+    BTreeSet* set = (BTreeSet*)baseline_alloc(sizeof(BTreeSet));
+    init_base(&set->base);
+    pthread_rwlock_init(&set->root_lock, NULL);
+    set->root = btree_node(true);
+    return &set->base;
+}
+
+// Inserts key into a write-locked leaf with room for it, unless present
+static bool btree_leaf_insert(BTreeNode* leaf, int key) {
+    int i = btree_lower_bound(leaf, key);
+    if (i < leaf->count && leaf->keys[i] == key) return false;
+    memmove(&leaf->keys[i + 1], &leaf->keys[i], (leaf->count - i) * sizeof(int));
+    leaf->keys[i] = key;
+    leaf->count++;
+    return true;
+}
+
+// Write-locks the root for a splitting descent. root_lock is only taken
+// exclusively when the root itself is full and has to grow the tree.
+static BTreeNode* btree_lock_root_for_split(BTreeSet* set, int key) {
+    pthread_rwlock_rdlock(&set->root_lock);
+    BTreeNode* n = set->root;
+    pthread_rwlock_wrlock(&n->lock);
+    if (n->count < BTREE_MAX_KEYS) {
+        pthread_rwlock_unlock(&set->root_lock);
+        return n;
+    }
+    pthread_rwlock_unlock(&n->lock);
+    pthread_rwlock_unlock(&set->root_lock);
+
+    pthread_rwlock_wrlock(&set->root_lock);
+    n = set->root;
+    pthread_rwlock_wrlock(&n->lock);
+    if (n->count == BTREE_MAX_KEYS) {
+        // Nobody can reach the new root before root_lock is released, so
+        // step straight to the half that will take the key
+        BTreeNode* root = btree_node(false);
+        root->children[0] = n;
+        BTreeNode* right = btree_split_child(root, 0, n);
+        set->root = root;
+        if (key >= root->keys[0]) {
+            pthread_rwlock_wrlock(&right->lock);
+            pthread_rwlock_unlock(&n->lock);
+            n = right;
+        }
+    }
+    pthread_rwlock_unlock(&set->root_lock);
+    return n;
+}
+
+bool baseline_insert_btree(SkipList* list, int key, int value) {
+    (void)value;
+    BTreeSet* set = (BTreeSet*)list;
+
+    // Optimistic pass: read-locked descent, write lock on the leaf only
+    BTreeNode* n = btree_find_leaf(set, key, true);
+    int pos = btree_lower_bound(n, key);
+    if (pos < n->count && n->keys[pos] == key) {
+        pthread_rwlock_unlock(&n->lock);
+        return false;
+    }
+    if (n->count < BTREE_MAX_KEYS) {
+        btree_leaf_insert(n, key);
+        pthread_rwlock_unlock(&n->lock);
+        atomic_fetch_add(&list->size, 1);
+        return true;
+    }
+    pthread_rwlock_unlock(&n->lock);
+
+    // The leaf is full: descend again with write locks, splitting full nodes
+    n = btree_lock_root_for_split(set, key);
+    while (!n->leaf) {
+        int i = btree_child_index(n, key);
+        BTreeNode* child = n->children[i];
+        pthread_rwlock_wrlock(&child->lock);
+        if (child->count == BTREE_MAX_KEYS) {
+            BTreeNode* right = btree_split_child(n, i, child);
+            if (key >= n->keys[i]) {
+                pthread_rwlock_wrlock(&right->lock);
+                pthread_rwlock_unlock(&child->lock);
+                child = right;
+            }
+        }
+        pthread_rwlock_unlock(&n->lock);
+        n = child;
+    }
+
+    bool inserted = btree_leaf_insert(n, key);
+    pthread_rwlock_unlock(&n->lock);
+
+    if (inserted) atomic_fetch_add(&list->size, 1);
+    return inserted;
+}
+
+bool baseline_delete_btree(SkipList* list, int key) {
+    BTreeNode* leaf = btree_find_leaf((BTreeSet*)list, key, true);
+    int i = btree_lower_bound(leaf, key);
+    bool deleted = i < leaf->count && leaf->keys[i] == key;
+    if (deleted) {
+        memmove(&leaf->keys[i], &leaf->keys[i + 1], (leaf->count - i - 1) * sizeof(int));
+        leaf->count--;
+    }
+    pthread_rwlock_unlock(&leaf->lock);
+
+    if (deleted) atomic_fetch_sub(&list->size, 1);
+    return deleted;
+}
+
+bool baseline_contains_btree(SkipList* list, int key) {
+    BTreeNode* leaf = btree_find_leaf((BTreeSet*)list, key, false);
+    int i = btree_lower_bound(leaf, key);
+    bool found = i < leaf->count && leaf->keys[i] == key;
+    pthread_rwlock_unlock(&leaf->lock);
+    return found;
+}
+
+void baseline_destroy_btree(SkipList* list) {
+    BTreeSet* set = (BTreeSet*)list;
+    btree_free(set->root);
+    pthread_rwlock_destroy(&set->root_lock);
+    free(set);
+}
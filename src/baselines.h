@@ -0,0 +1,45 @@
+#ifndef BASELINES_H
+#define BASELINES_H
+
+#include "skiplist_common.h"
+
+/**
+ * Baseline Structures for Comparison
+ *
+ * Three non-skip-list sets behind the same create/insert/delete/contains/
+ * destroy signatures as the skip lists, so bin/benchmark can drive them
+ * unchanged and report them in the same CSV:
+ *
+ *   avl   - AVL tree behind one reader-writer lock (lookups run in
+ *           parallel, updates are serialized)
+ *   hash  - Chained hash set with lock striping; the table doubles under
+ *           all stripe locks when the load factor exceeds 4. Point ops only.
+ *   btree - B+tree with per-node reader-writer locks and lock coupling;
+ *           inserts descend read-locked and only redo the descent with
+ *           preemptive splits when the leaf is full; deletes never merge
+ *
+ * Each returns a SkipList* whose only meaningful field is `size`, so the
+ * size-based reports (memory, metrics) keep working. head/tail are NULL,
+ * and skip-list-specific code (structure stats, validation) must not be
+ * pointed at them. Values are ignored; these are sets.
+ */
+
+SkipList* baseline_create_avl(void);
+bool baseline_insert_avl(SkipList* set, int key, int value);
+bool baseline_delete_avl(SkipList* set, int key);
+bool baseline_contains_avl(SkipList* set, int key);
+void baseline_destroy_avl(SkipList* set);
+
+SkipList* baseline_create_hash(void);
+bool baseline_insert_hash(SkipList* set, int key, int value);
+bool baseline_delete_hash(SkipList* set, int key);
+bool baseline_contains_hash(SkipList* set, int key);
+void baseline_destroy_hash(SkipList* set);
+
+SkipList* baseline_create_btree(void);
+bool baseline_insert_btree(SkipList* set, int key, int value);
+bool baseline_delete_btree(SkipList* set, int key);
+bool baseline_contains_btree(SkipList* set, int key);
+void baseline_destroy_btree(SkipList* set);
+
+#endif // BASELINES_H
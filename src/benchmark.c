@@ -1,8 +1,17 @@
 #include "skiplist_common.h"
+#include "perf_counters.h"
+#include "latency_hist.h"
+#include "scenario.h"
+#include "baselines.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
 #include <omp.h>
 
 typedef struct {
@@ -16,15 +25,70 @@ typedef struct {
     int search_percent;
     int initial_size;
     int warmup_ops;
+    bool perf;
+    bool structure;
+    bool validate;        // Parallel structural validation after the run
+    double duration;      // Seconds; > 0 switches from fixed ops to timed runs
+    double interval;      // Seconds between progress/memory reports (duration mode)
+    bool memory_csv;      // Append memory columns to CSV output
+    char trace_path[256]; // Chrome trace output (empty: disabled)
+    char metrics_path[256]; // Prometheus text file (empty: disabled)
+    bool per_thread;      // Per-thread ops, latency percentiles and fairness
+    double rate;          // Open loop: ops/sec issued per thread (0 = closed loop)
+    int readers;          // Reader/writer groups (0/0: every thread runs one mix)
+    int writers;
+    int reader_insert_percent;
+    int reader_delete_percent;
+    int writer_insert_percent;
+    int writer_delete_percent;
+    char scenario_path[256]; // Phased scenario file (empty: single workload)
+    double oversubscribe; // > 0: threads = factor x online cores
+    int cores;            // Online cores, for oversubscribed runs
+    int dispatch;         // DISPATCH_DIRECT or DISPATCH_INDIRECT
+    bool dispatch_csv;    // --dispatch given: append a dispatch column
 } BenchmarkConfig;
 
+// How the workload loop reaches insert/delete/contains
+enum { DISPATCH_DIRECT = 0, DISPATCH_INDIRECT };
+static const char* dispatch_names[] = { "direct", "indirect" };
+
+// Thread groups of the readwrite workload; writers take the lowest tids
+enum { GROUP_READERS = 0, GROUP_WRITERS, NUM_GROUPS };
+
+typedef struct {
+    int threads;
+    long long ops;
+    double throughput;          // Group ops over the whole run's wall time
+    LatencyHistogram latency;
+} GroupResult;
+
+typedef struct {
+    uint64_t nodes_allocated;   // Since the list was created (sentinels included)
+    uint64_t nodes_freed;
+    long long live_nodes;       // Linked, unmarked keys
+    long long retired_nodes;    // Deleted but never freed (leaked by design)
+    long peak_rss_kb;
+} MemoryReport;
+
 typedef struct {
     double total_time;
     double throughput;
-    int successful_ops;
-    int failed_ops;
+    long long total_ops;
+    long long successful_ops;
+    long long failed_ops;
+    PerfTotals perf;
+    double hops_before;     // Avg search path sampled before/after the run (--structure)
+    double hops_after;
+    SkipListStats structure;
+    MemoryReport memory;
+    double fairness;        // Jain's index over per-thread throughput (--per-thread)
+    LatencyHistogram latency;
+    GroupResult groups[NUM_GROUPS];  // Only filled for the readwrite workload
 } BenchmarkResult;
 
+// Random searches used to sample the average path length (--structure)
+#define HOP_SAMPLES 10000
+
 typedef struct {
     SkipList* (*create)(void);
     bool (*insert)(SkipList*, int, int);
@@ -54,6 +118,24 @@ SkipListOps get_operations(const char* impl) {
         ops.delete = skiplist_delete_lockfree;
         ops.contains = skiplist_contains_lockfree;
         ops.destroy = skiplist_destroy_lockfree;
+    } else if (strcmp(impl, "avl") == 0) {
+        ops.create = baseline_create_avl;
+        ops.insert = baseline_insert_avl;
+        ops.delete = baseline_delete_avl;
+        ops.contains = baseline_contains_avl;
+        ops.destroy = baseline_destroy_avl;
+    } else if (strcmp(impl, "hash") == 0) {
+        ops.create = baseline_create_hash;
+        ops.insert = baseline_insert_hash;
+        ops.delete = baseline_delete_hash;
+        ops.contains = baseline_contains_hash;
+        ops.destroy = baseline_destroy_hash;
+    } else if (strcmp(impl, "btree") == 0) {
+        ops.create = baseline_create_btree;
+        ops.insert = baseline_insert_btree;
+        ops.delete = baseline_delete_btree;
+        ops.contains = baseline_contains_btree;
+        ops.destroy = baseline_destroy_btree;
     } else {
         fprintf(stderr, "Unknown implementation: %s\n", impl);
         exit(1);
@@ -62,6 +144,167 @@ SkipListOps get_operations(const char* impl) {
     return ops;
 }
 
+// The baselines (avl, hash, btree) share SkipListOps but have no towers, so
+// structure sampling and node accounting don't apply to them
+static bool is_skiplist_impl(const char* impl) {
+    return strcmp(impl, "coarse") == 0 || strcmp(impl, "fine") == 0 ||
+           strcmp(impl, "lockfree") == 0;
+}
+
+// Per-thread instrumentation around the timed region (NULL when --perf is off)
+static PerfSession* perf_session = NULL;
+
+static inline void worker_begin(void) {
+    perf_thread_start(perf_session);
+}
+
+static inline void worker_end(void) {
+    perf_thread_stop(perf_session);
+}
+
+// ------------------------------------------------------------------------
+// Duration mode: workers run until a monitor thread raises stop_flag and
+// publish their op count every PROGRESS_MASK + 1 ops for interval reports.
+// ------------------------------------------------------------------------
+#define PROGRESS_MASK 1023
+#define MAX_BENCH_THREADS MAX_INSTRUMENT_THREADS
+
+typedef struct {
+    _Atomic(long) ops;
+} __attribute__((aligned(CACHE_LINE_SIZE))) ThreadProgress;
+
+static _Atomic(bool) stop_flag = false;
+static ThreadProgress progress[MAX_BENCH_THREADS];
+
+// Per-thread results for fairness reporting (--per-thread)
+typedef struct {
+    long ops;
+    long long successful;
+    double finish_time;          // Seconds from workload start to this thread's last op
+    LatencyHistogram latency;    // Only filled with --per-thread
+} __attribute__((aligned(CACHE_LINE_SIZE))) ThreadStats;
+
+static ThreadStats thread_stats[MAX_BENCH_THREADS];
+
+static inline bool keep_running(BenchmarkConfig* config, long i) {
+    if (config->duration <= 0) return i < config->ops_per_thread;
+    if ((i & PROGRESS_MASK) == 0) {
+        atomic_store_explicit(&progress[omp_get_thread_num()].ops, i, memory_order_relaxed);
+    }
+    return !atomic_load_explicit(&stop_flag, memory_order_relaxed);
+}
+
+static long current_rss_kb(void) {
+    long pages_total, pages_resident;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    int n = fscanf(f, "%ld %ld", &pages_total, &pages_resident);
+    fclose(f);
+    return n == 2 ? pages_resident * (sysconf(_SC_PAGESIZE) / 1024) : 0;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;  // Kilobytes on Linux
+}
+
+// Prometheus snapshot; returns the time the snapshot took in microseconds
+static double export_metrics(BenchmarkConfig* config, SkipList* list) {
+    double start = omp_get_wtime();
+    if (!skiplist_metrics_write_file(list, config->impl, config->metrics_path)) {
+        fprintf(stderr, "Warning: failed to write metrics to %s\n", config->metrics_path);
+    }
+    return (omp_get_wtime() - start) * 1e6;
+}
+
+// Node accounting relative to a snapshot taken before the list was created
+static void collect_memory(SkipList* list, MemoryStats* baseline, MemoryReport* report) {
+    MemoryStats now;
+    skiplist_memory_stats(&now);
+    report->nodes_allocated = now.nodes_allocated - baseline->nodes_allocated;
+    report->nodes_freed = now.nodes_freed - baseline->nodes_freed;
+    report->live_nodes = atomic_load(&list->size);
+    long long outstanding = (long long)report->nodes_allocated - (long long)report->nodes_freed;
+    report->retired_nodes = outstanding - report->live_nodes - 2;  // Minus head/tail sentinels
+    if (report->retired_nodes < 0) report->retired_nodes = 0;      // size is updated after linking
+    report->peak_rss_kb = peak_rss_kb();
+}
+
+typedef struct {
+    BenchmarkConfig* config;
+    SkipList* list;
+    MemoryStats* baseline;
+    FILE* out;
+} MonitorArgs;
+
+static void sleep_seconds(double seconds) {
+    if (seconds <= 0) return;
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+}
+
+static void* duration_monitor(void* arg);
+
+// In duration mode a monitor thread ends the run (and reports intervals
+// to stderr when CSV output must stay clean)
+static void start_monitor(pthread_t* monitor, MonitorArgs* args) {
+    if (args->config->duration <= 0) return;
+    atomic_store(&stop_flag, false);
+    memset(progress, 0, sizeof(progress));
+    pthread_create(monitor, NULL, duration_monitor, args);
+}
+
+static void join_monitor(pthread_t monitor, MonitorArgs* args) {
+    if (args->config->duration <= 0) return;
+    pthread_join(monitor, NULL);
+}
+
+static void* duration_monitor(void* arg) {
+    MonitorArgs* m = (MonitorArgs*)arg;
+    BenchmarkConfig* config = m->config;
+    double start = omp_get_wtime();
+    double next_report = config->interval > 0 ? config->interval : config->duration;
+    long last_ops = 0;
+    double last_time = 0.0;
+    
+    while (true) {
+        double elapsed = omp_get_wtime() - start;
+        if (elapsed >= config->duration) break;
+        
+        double wake = next_report < config->duration ? next_report : config->duration;
+        sleep_seconds(wake - elapsed);
+        elapsed = omp_get_wtime() - start;
+        
+        if (config->interval > 0 && elapsed >= next_report && elapsed < config->duration) {
+            long ops = 0;
+            for (int t = 0; t < config->num_threads; t++) {
+                ops += atomic_load_explicit(&progress[t].ops, memory_order_relaxed);
+            }
+            MemoryReport mem;
+            collect_memory(m->list, m->baseline, &mem);
+            uint64_t outstanding = mem.nodes_allocated - mem.nodes_freed;
+            fprintf(m->out, "[%7.2fs] %.2f ops/sec | live %lld retired %lld | nodes %.1f MB | RSS %.1f MB\n",
+                    elapsed, (ops - last_ops) / (elapsed - last_time),
+                    mem.live_nodes, mem.retired_nodes,
+                    outstanding * sizeof(Node) / (1024.0 * 1024.0),
+                    current_rss_kb() / 1024.0);
+            fflush(m->out);
+            if (config->metrics_path[0] != '\0') {
+                export_metrics(config, m->list);
+            }
+            last_ops = ops;
+            last_time = elapsed;
+            next_report += config->interval;
+        }
+    }
+    
+    atomic_store(&stop_flag, true);
+    return NULL;
+}
+
 void prepopulate_list(SkipList* list, SkipListOps* ops, int size, int key_range) {
     #pragma omp parallel for
     for (int i = 0; i < size; i++) {
@@ -71,122 +314,306 @@ void prepopulate_list(SkipList* list, SkipListOps* ops, int size, int key_range)
     }
 }
 
-BenchmarkResult run_insert_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
-    BenchmarkResult result = {0};
-    int successful = 0;
-    
-    double start = omp_get_wtime();
-    
-    #pragma omp parallel num_threads(config->num_threads) reduction(+:successful)
-    {
-        unsigned int seed = omp_get_thread_num() * 12345;
-        
-        for (int i = 0; i < config->ops_per_thread; i++) {
-            int key = rand_r(&seed) % config->key_range;
-            if (ops->insert(list, key, key)) {
-                successful++;
-            }
+// Operation mix of one workload. Single-op mixes skip the op_type draw so
+// each workload keeps its original random key stream.
+typedef struct {
+    int insert_percent;
+    int delete_percent;
+    bool random_ops;
+    unsigned int seed_base;
+    int scan_length;        // > 0: runs of consecutive keys from a random start
+} WorkloadMix;
+
+// Open loop: sleep while the next intended start is far away, then poll.
+// Polling yields so waiting threads don't starve busy ones on shared cores.
+static void wait_until_ns(uint64_t target) {
+    while (true) {
+        uint64_t now = hist_now_ns();
+        if (now >= target) return;
+        if (target - now > 100000) {
+            uint64_t delta = target - now - 50000;
+            struct timespec ts = { (time_t)(delta / 1000000000), (long)(delta % 1000000000) };
+            nanosleep(&ts, NULL);
+        } else {
+            sched_yield();
         }
     }
-    
-    double end = omp_get_wtime();
-    
-    result.total_time = end - start;
-    result.successful_ops = successful;
-    result.failed_ops = (config->num_threads * config->ops_per_thread) - successful;
-    result.throughput = (config->num_threads * config->ops_per_thread) / result.total_time;
-    
-    return result;
 }
 
-BenchmarkResult run_delete_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
-    BenchmarkResult result = {0};
-    int successful = 0;
-    
-    double start = omp_get_wtime();
-    
-    #pragma omp parallel num_threads(config->num_threads) reduction(+:successful)
-    {
-        unsigned int seed = omp_get_thread_num() * 23456;
-        
-        for (int i = 0; i < config->ops_per_thread; i++) {
-            int key = rand_r(&seed) % config->key_range;
-            if (ops->delete(list, key)) {
-                successful++;
-            }
+static inline bool reader_writer_mode(BenchmarkConfig* config) {
+    return config->readers + config->writers > 0;
+}
+
+static inline int thread_group(BenchmarkConfig* config, int tid) {
+    return tid < config->writers ? GROUP_WRITERS : GROUP_READERS;
+}
+
+static inline void finish_thread_stats(ThreadStats* ts, long ops, long long successful, double start) {
+    ts->ops = ops;
+    ts->successful = successful;
+    ts->finish_time = omp_get_wtime() - start;
+}
+
+// One driver per implementation calling the operations directly, plus the
+// function-pointer driver (--dispatch indirect) for comparison
+#define DRIVER_NAME     run_workload_indirect
+#define DRIVER_INSERT   ops->insert
+#define DRIVER_DELETE   ops->delete
+#define DRIVER_CONTAINS ops->contains
+#include "workload_driver.h"
+
+#define DRIVER_NAME     run_workload_coarse
+#define DRIVER_INSERT   skiplist_insert_coarse
+#define DRIVER_DELETE   skiplist_delete_coarse
+#define DRIVER_CONTAINS skiplist_contains_coarse
+#include "workload_driver.h"
+
+#define DRIVER_NAME     run_workload_fine
+#define DRIVER_INSERT   skiplist_insert_fine
+#define DRIVER_DELETE   skiplist_delete_fine
+#define DRIVER_CONTAINS skiplist_contains_fine
+#include "workload_driver.h"
+
+#define DRIVER_NAME     run_workload_lockfree
+#define DRIVER_INSERT   skiplist_insert_lockfree
+#define DRIVER_DELETE   skiplist_delete_lockfree
+#define DRIVER_CONTAINS skiplist_contains_lockfree
+#include "workload_driver.h"
+
+#define DRIVER_NAME     run_workload_avl
+#define DRIVER_INSERT   baseline_insert_avl
+#define DRIVER_DELETE   baseline_delete_avl
+#define DRIVER_CONTAINS baseline_contains_avl
+#include "workload_driver.h"
+
+#define DRIVER_NAME     run_workload_hash
+#define DRIVER_INSERT   baseline_insert_hash
+#define DRIVER_DELETE   baseline_delete_hash
+#define DRIVER_CONTAINS baseline_contains_hash
+#include "workload_driver.h"
+
+#define DRIVER_NAME     run_workload_btree
+#define DRIVER_INSERT   baseline_insert_btree
+#define DRIVER_DELETE   baseline_delete_btree
+#define DRIVER_CONTAINS baseline_contains_btree
+#include "workload_driver.h"
+
+// Priority queue (pqueue workload, lockfree only): the delete slot pops the
+// minimum and ignores the drawn key
+static inline bool pqueue_pop_min(SkipList* list, int key) {
+    (void)key;
+    int min_key, value;
+    return skiplist_pop_min_lockfree(list, &min_key, &value);
+}
+
+#define DRIVER_NAME     run_workload_pqueue
+#define DRIVER_INSERT   skiplist_insert_lockfree
+#define DRIVER_DELETE   pqueue_pop_min
+#define DRIVER_CONTAINS skiplist_contains_lockfree
+#include "workload_driver.h"
+
+// SprayList pops (pqueue_spray workload) spread over the first keys in
+// proportion to the number of popping threads
+static int spray_threads = 1;
+
+static inline bool pqueue_pop_spray(SkipList* list, int key) {
+    (void)key;
+    int min_key, value;
+    return skiplist_pop_approx_min_lockfree(list, spray_threads, &min_key, &value);
+}
+
+#define DRIVER_NAME     run_workload_pqueue_spray
+#define DRIVER_INSERT   skiplist_insert_lockfree
+#define DRIVER_DELETE   pqueue_pop_spray
+#define DRIVER_CONTAINS skiplist_contains_lockfree
+#include "workload_driver.h"
+
+static BenchmarkResult run_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config,
+                                    WorkloadMix group_mix[NUM_GROUPS]) {
+    if (config->dispatch == DISPATCH_DIRECT) {
+        if (strcmp(config->impl, "coarse") == 0) {
+            return run_workload_coarse(list, ops, config, group_mix);
+        } else if (strcmp(config->impl, "fine") == 0) {
+            return run_workload_fine(list, ops, config, group_mix);
+        } else if (strcmp(config->impl, "lockfree") == 0) {
+            return run_workload_lockfree(list, ops, config, group_mix);
+        } else if (strcmp(config->impl, "avl") == 0) {
+            return run_workload_avl(list, ops, config, group_mix);
+        } else if (strcmp(config->impl, "hash") == 0) {
+            return run_workload_hash(list, ops, config, group_mix);
+        } else if (strcmp(config->impl, "btree") == 0) {
+            return run_workload_btree(list, ops, config, group_mix);
         }
     }
-    
-    double end = omp_get_wtime();
-    
-    result.total_time = end - start;
-    result.successful_ops = successful;
-    result.failed_ops = (config->num_threads * config->ops_per_thread) - successful;
-    result.throughput = (config->num_threads * config->ops_per_thread) / result.total_time;
-    
-    return result;
+    return run_workload_indirect(list, ops, config, group_mix);
+}
+
+BenchmarkResult run_insert_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
+    WorkloadMix mix = { 100, 0, false, 12345, 0 };
+    return run_workload(list, ops, config, (WorkloadMix[NUM_GROUPS]){ mix, mix });
+}
+
+BenchmarkResult run_delete_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
+    WorkloadMix mix = { 0, 100, false, 23456, 0 };
+    return run_workload(list, ops, config, (WorkloadMix[NUM_GROUPS]){ mix, mix });
 }
 
 BenchmarkResult run_readonly_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
-    BenchmarkResult result = {0};
-    int successful = 0;
-    
-    double start = omp_get_wtime();
-    
-    #pragma omp parallel num_threads(config->num_threads) reduction(+:successful)
-    {
-        unsigned int seed = omp_get_thread_num() * 34567;
-        
-        for (int i = 0; i < config->ops_per_thread; i++) {
-            int key = rand_r(&seed) % config->key_range;
-            if (ops->contains(list, key)) {
-                successful++;
-            }
+    WorkloadMix mix = { 0, 0, false, 34567, 0 };
+    return run_workload(list, ops, config, (WorkloadMix[NUM_GROUPS]){ mix, mix });
+}
+
+BenchmarkResult run_mixed_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
+    WorkloadMix mix = { config->insert_percent, config->delete_percent, true, 45678, 0 };
+    return run_workload(list, ops, config, (WorkloadMix[NUM_GROUPS]){ mix, mix });
+}
+
+// Dedicated writer threads alongside reader threads, each group with its own mix
+BenchmarkResult run_readwrite_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
+    WorkloadMix group_mix[NUM_GROUPS] = {
+        [GROUP_READERS] = { config->reader_insert_percent, config->reader_delete_percent, true, 56789, 0 },
+        [GROUP_WRITERS] = { config->writer_insert_percent, config->writer_delete_percent, true, 67890, 0 },
+    };
+    return run_workload(list, ops, config, group_mix);
+}
+
+// Inserts of random keys against pop_min, e.g. a timer queue
+BenchmarkResult run_pqueue_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
+    WorkloadMix mix = { config->insert_percent, 100 - config->insert_percent, true, 78901, 0 };
+    return run_workload_pqueue(list, ops, config, (WorkloadMix[NUM_GROUPS]){ mix, mix });
+}
+
+// Same mix with the relaxed SprayList pop
+BenchmarkResult run_pqueue_spray_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
+    WorkloadMix mix = { config->insert_percent, 100 - config->insert_percent, true, 78901, 0 };
+    spray_threads = config->num_threads;
+    return run_workload_pqueue_spray(list, ops, config, (WorkloadMix[NUM_GROUPS]){ mix, mix });
+}
+
+void print_perf_results(BenchmarkResult* result) {
+    double total_ops = (double)result->total_ops;
+    PerfTotals* perf = &result->perf;
+
+    printf("--- Hardware Counters (per op) ---\n");
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (perf->valid[e]) {
+            printf("%-14s %.2f\n", perf_event_name(e), perf->values[e] / total_ops);
+        } else {
+            printf("%-14s n/a\n", perf_event_name(e));
         }
     }
-    
-    double end = omp_get_wtime();
-    
-    result.total_time = end - start;
-    result.successful_ops = successful;
-    result.failed_ops = (config->num_threads * config->ops_per_thread) - successful;
-    result.throughput = (config->num_threads * config->ops_per_thread) / result.total_time;
-    
-    return result;
+    if (perf->valid[PERF_CYCLES] && perf->valid[PERF_INSTRUCTIONS] && perf->values[PERF_CYCLES] > 0) {
+        printf("%-14s %.3f\n", "IPC",
+               (double)perf->values[PERF_INSTRUCTIONS] / perf->values[PERF_CYCLES]);
+    }
 }
 
-BenchmarkResult run_mixed_workload(SkipList* list, SkipListOps* ops, BenchmarkConfig* config) {
-    BenchmarkResult result = {0};
-    int successful = 0;
-    
-    double start = omp_get_wtime();
+void print_structure_results(BenchmarkResult* result) {
+    printf("Avg search hops: %.2f before, %.2f after (sampled)\n",
+           result->hops_before, result->hops_after);
+    print_skiplist_stats(&result->structure);
+}
+
+// Jain's fairness index over per-thread throughput: 1 = perfectly fair,
+// 1/n = one thread did all the work
+static double jain_index(double* x, int n) {
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += x[i];
+        sum_sq += x[i] * x[i];
+    }
+    return sum_sq > 0.0 ? (sum * sum) / (n * sum_sq) : 1.0;
+}
+
+static void summarize_threads(BenchmarkConfig* config, BenchmarkResult* result) {
+    double rates[MAX_BENCH_THREADS];
+    hist_reset(&result->latency);
     
-    #pragma omp parallel num_threads(config->num_threads) reduction(+:successful)
-    {
-        unsigned int seed = omp_get_thread_num() * 45678;
+    for (int t = 0; t < config->num_threads; t++) {
+        ThreadStats* ts = &thread_stats[t];
+        rates[t] = ts->finish_time > 0 ? ts->ops / ts->finish_time : 0.0;
+        hist_merge(&result->latency, &ts->latency);
         
-        for (int i = 0; i < config->ops_per_thread; i++) {
-            int op_type = rand_r(&seed) % 100;
-            int key = rand_r(&seed) % config->key_range;
-            
-            if (op_type < config->insert_percent) {
-                if (ops->insert(list, key, key)) successful++;
-            } else if (op_type < config->insert_percent + config->delete_percent) {
-                if (ops->delete(list, key)) successful++;
-            } else {
-                if (ops->contains(list, key)) successful++;
-            }
+        if (reader_writer_mode(config)) {
+            GroupResult* group = &result->groups[thread_group(config, t)];
+            group->threads++;
+            group->ops += ts->ops;
+            hist_merge(&group->latency, &ts->latency);
         }
     }
+    result->fairness = jain_index(rates, config->num_threads);
     
-    double end = omp_get_wtime();
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        GroupResult* group = &result->groups[g];
+        group->throughput = result->total_time > 0 ? group->ops / result->total_time : 0.0;
+    }
+}
+
+void print_group_results(BenchmarkResult* result) {
+    static const char* group_names[NUM_GROUPS] = { "readers", "writers" };
     
-    result.total_time = end - start;
-    result.successful_ops = successful;
-    result.failed_ops = (config->num_threads * config->ops_per_thread) - successful;
-    result.throughput = (config->num_threads * config->ops_per_thread) / result.total_time;
+    printf("=== Reader/Writer Groups ===\n");
+    printf("%-8s %7s %12s %13s %13s %9s %9s %9s %9s\n",
+           "group", "threads", "ops", "ops/sec", "ops/sec/thr", "p50(ns)", "p99(ns)", "p99.9(ns)", "max(ns)");
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        GroupResult* group = &result->groups[g];
+        if (group->threads == 0) continue;
+        printf("%-8s %7d %12lld %13.2f %13.2f %9lu %9lu %9lu %9lu\n",
+               group_names[g], group->threads, group->ops, group->throughput,
+               group->throughput / group->threads,
+               (unsigned long)hist_percentile(&group->latency, 50.0),
+               (unsigned long)hist_percentile(&group->latency, 99.0),
+               (unsigned long)hist_percentile(&group->latency, 99.9),
+               (unsigned long)group->latency.max);
+    }
+    printf("============================\n\n");
+}
+
+void print_thread_results(BenchmarkConfig* config, BenchmarkResult* result) {
+    printf("=== Per-Thread ===\n");
+    printf("%-4s %12s %7s %10s %13s %9s %9s %9s %9s\n",
+           "tid", "ops", "share", "finish(s)", "ops/sec", "p50(ns)", "p99(ns)", "p99.9(ns)", "max(ns)");
+    for (int t = 0; t < config->num_threads; t++) {
+        ThreadStats* ts = &thread_stats[t];
+        printf("%-4d %12ld %6.2f%% %10.4f %13.2f %9lu %9lu %9lu %9lu\n",
+               t, ts->ops, 100.0 * ts->ops / result->total_ops, ts->finish_time,
+               ts->finish_time > 0 ? ts->ops / ts->finish_time : 0.0,
+               (unsigned long)hist_percentile(&ts->latency, 50.0),
+               (unsigned long)hist_percentile(&ts->latency, 99.0),
+               (unsigned long)hist_percentile(&ts->latency, 99.9),
+               (unsigned long)ts->latency.max);
+    }
+    printf("All threads: p50 %lu ns, p99 %lu ns, p99.9 %lu ns, max %lu ns\n",
+           (unsigned long)hist_percentile(&result->latency, 50.0),
+           (unsigned long)hist_percentile(&result->latency, 99.0),
+           (unsigned long)hist_percentile(&result->latency, 99.9),
+           (unsigned long)result->latency.max);
+    printf("Jain's fairness index: %.4f (1.0 = all threads equal)\n", result->fairness);
+    printf("==================\n\n");
+}
+
+void print_memory_results(BenchmarkResult* result) {
+    MemoryReport* mem = &result->memory;
+    uint64_t outstanding = mem->nodes_allocated - mem->nodes_freed;
     
-    return result;
+    printf("=== Memory ===\n");
+    if (mem->nodes_allocated == 0) {  // Baselines don't allocate skip list nodes
+        printf("Live keys:            %lld\n", mem->live_nodes);
+        printf("Peak RSS:             %.2f MB\n", mem->peak_rss_kb / 1024.0);
+        printf("==============\n\n");
+        return;
+    }
+    printf("Node bytes allocated: %.2f MB (%lu nodes of %zu bytes)\n",
+           mem->nodes_allocated * sizeof(Node) / (1024.0 * 1024.0),
+           (unsigned long)mem->nodes_allocated, sizeof(Node));
+    printf("Node bytes in use:    %.2f MB\n", outstanding * sizeof(Node) / (1024.0 * 1024.0));
+    printf("Live nodes:           %lld\n", mem->live_nodes);
+    printf("Retired nodes:        %lld (deleted, not freed)\n", mem->retired_nodes);
+    printf("Peak RSS:             %.2f MB\n", mem->peak_rss_kb / 1024.0);
+    if (mem->live_nodes > 0) {
+        printf("Bytes per live key:   %.1f\n", (double)outstanding * sizeof(Node) / mem->live_nodes);
+    }
+    printf("==============\n\n");
 }
 
 void print_results(BenchmarkConfig* config, BenchmarkResult* result) {
@@ -194,55 +621,412 @@ void print_results(BenchmarkConfig* config, BenchmarkResult* result) {
     printf("Implementation: %s\n", config->impl);
     printf("Threads: %d\n", config->num_threads);
     printf("Workload: %s\n", config->workload);
-    printf("Operations: %d\n", config->num_threads * config->ops_per_thread);
+    if (config->oversubscribe > 0) {
+        printf("Oversubscription: %.2fx (%d cores)\n", config->oversubscribe, config->cores);
+    }
+    printf("Dispatch: %s\n", dispatch_names[config->dispatch]);
+    if (strcmp(config->impl, "coarse") == 0 || strcmp(config->impl, "fine") == 0 ||
+        strcmp(config->impl, "hash") == 0) {
+        printf("Lock policy: %s\n", skiplock_policy_name(skiplock_policy));
+    }
+    if (reader_writer_mode(config)) {
+        printf("Readers: %d (%d%% insert, %d%% delete)\n", config->readers,
+               config->reader_insert_percent, config->reader_delete_percent);
+        printf("Writers: %d (%d%% insert, %d%% delete)\n", config->writers,
+               config->writer_insert_percent, config->writer_delete_percent);
+    }
+    printf("Operations: %lld\n", result->total_ops);
     printf("Key Range: %d\n", config->key_range);
     printf("Time: %.4f seconds\n", result->total_time);
     printf("Throughput: %.2f ops/sec\n", result->throughput);
-    printf("Successful: %d\n", result->successful_ops);
-    printf("Failed: %d\n", result->failed_ops);
+    if (config->rate > 0) {
+        printf("Offered load: %.2f ops/sec (%.2f per thread, open loop)\n",
+               config->rate * config->num_threads, config->rate);
+        printf("Latency from intended start: p50 %lu ns, p99 %lu ns, p99.9 %lu ns, max %lu ns\n",
+               (unsigned long)hist_percentile(&result->latency, 50.0),
+               (unsigned long)hist_percentile(&result->latency, 99.0),
+               (unsigned long)hist_percentile(&result->latency, 99.9),
+               (unsigned long)result->latency.max);
+    }
+    printf("Successful: %lld\n", result->successful_ops);
+    printf("Failed: %lld\n", result->failed_ops);
+    if (config->perf) {
+        print_perf_results(result);
+    }
     printf("========================\n\n");
 }
 
-void print_csv_header() {
-    printf("impl,threads,workload,ops,key_range,time,throughput,successful,failed\n");
+void print_contention_stats(BenchmarkConfig* config, BenchmarkResult* result) {
+    ContentionStats stats;
+    if (strcmp(config->impl, "lockfree") != 0) return;
+    if (!skiplist_contention_stats(&stats)) return;  // Built without -DSKIPLIST_STATS
+    
+    double total_ops = (double)result->total_ops;
+    uint64_t cas_total = 0;
+    
+    printf("=== Contention Counters ===\n");
+    for (int level = 0; level <= MAX_LEVEL; level++) {
+        if (stats.cas_failures[level] == 0) continue;
+        printf("CAS failures L%-2d:    %lu\n", level, (unsigned long)stats.cas_failures[level]);
+        cas_total += stats.cas_failures[level];
+    }
+    printf("CAS failures total:  %lu (%.4f/op)\n", (unsigned long)cas_total, cas_total / total_ops);
+    printf("find() restarts:     %lu (%.4f/op)\n", (unsigned long)stats.find_restarts,
+           stats.find_restarts / total_ops);
+    printf("Helping unlinks:     %lu\n", (unsigned long)stats.helping_unlinks);
+    printf("backoff() calls:     %lu\n", (unsigned long)stats.backoff_calls);
+    printf("backoff() yields:    %lu\n", (unsigned long)stats.backoff_yields);
+    printf("Tower abandons:      %lu\n", (unsigned long)stats.tower_abandons);
+    printf("Towers cut short:    %lu\n", (unsigned long)stats.tower_levels_skipped);
+    printf("Retries exhausted:   %lu\n", (unsigned long)stats.retries_exhausted);
+    if (stats.pop_prefix_skips > 0 || stats.pop_cleanups > 0) {
+        printf("pop_min skips:       %lu\n", (unsigned long)stats.pop_prefix_skips);
+        printf("pop_min cleanups:    %lu\n", (unsigned long)stats.pop_cleanups);
+    }
+    printf("===========================\n\n");
+}
+
+void print_lock_profile(BenchmarkConfig* config, BenchmarkResult* result) {
+    LockProfile prof;
+    if (strcmp(config->impl, "lockfree") == 0) return;
+    if (!skiplist_lock_profile(&prof)) return;  // Built without -DSKIPLIST_LOCK_PROFILE
+    if (prof.acquisitions == 0) return;         // avl/btree use pthread rwlocks
+    
+    // Per-op breakdown of the threads' combined time. For coarse the search
+    // happens under the lock, so it shows up as hold time.
+    double total_ops = (double)result->total_ops;
+    double thread_ns = result->total_time * 1e9 * config->num_threads;
+    double wait_ns = prof.wait_ns / total_ops;
+    double hold_ns = prof.hold_ns / total_ops;
+    double other_ns = thread_ns / total_ops - wait_ns - hold_ns;
+    
+    printf("=== Lock Profile ===\n");
+    printf("Acquisitions:        %lu (%.2f/op)\n", (unsigned long)prof.acquisitions,
+           prof.acquisitions / total_ops);
+    printf("Max wait:            %.1f us\n", prof.max_wait_ns / 1e3);
+    printf("Validation failures: %lu\n", (unsigned long)prof.validation_failures);
+    printf("Head rescans:        %lu\n", (unsigned long)prof.head_rescans);
+    printf("Parked acquisitions: %lu (%.4f/op)\n", (unsigned long)prof.parks, prof.parks / total_ops);
+    printf("Per-op time:         %.1f ns\n", thread_ns / total_ops);
+    printf("  wait:              %.1f ns (%.1f%%)\n", wait_ns, 100.0 * wait_ns * total_ops / thread_ns);
+    printf("  hold:              %.1f ns (%.1f%%)\n", hold_ns, 100.0 * hold_ns * total_ops / thread_ns);
+    printf("  traverse/other:    %.1f ns (%.1f%%)\n", other_ns, 100.0 * other_ns * total_ops / thread_ns);
+    printf("====================\n\n");
+}
+
+void print_csv_header(BenchmarkConfig* config) {
+    printf("impl,threads,workload,ops,key_range,time,throughput,successful,failed");
+    if (config->perf) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            printf(",%s_per_op", perf_event_name(e));
+        }
+    }
+    if (config->structure) {
+        printf(",hops_before,hops_after,bytes_per_key");
+    }
+    if (config->rate > 0) {
+        printf(",offered_rate");
+    }
+    if (config->per_thread) {
+        printf(",fairness");
+    }
+    if (config->per_thread || config->rate > 0) {
+        printf(",p50_ns,p99_ns,p999_ns,max_ns");
+    }
+    if (config->oversubscribe > 0) {
+        printf(",cores,lock_policy");
+    }
+    if (config->dispatch_csv) {
+        printf(",dispatch");
+    }
+    if (reader_writer_mode(config)) {
+        printf(",readers,writers,reader_throughput,reader_p50_ns,reader_p99_ns"
+               ",writer_throughput,writer_p50_ns,writer_p99_ns");
+    }
+    if (config->memory_csv) {
+        printf(",nodes_allocated,live_nodes,retired_nodes,peak_rss_kb,bytes_per_live_key");
+    }
+    printf("\n");
 }
 
 void print_csv_results(BenchmarkConfig* config, BenchmarkResult* result) {
-    printf("%s,%d,%s,%d,%d,%.4f,%.2f,%d,%d\n",
+    printf("%s,%d,%s,%lld,%d,%.4f,%.2f,%lld,%lld",
            config->impl, config->num_threads, config->workload,
-           config->num_threads * config->ops_per_thread,
+           result->total_ops,
            config->key_range, result->total_time, result->throughput,
            result->successful_ops, result->failed_ops);
+    if (config->perf) {
+        double total_ops = (double)result->total_ops;
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (result->perf.valid[e]) {
+                printf(",%.4f", result->perf.values[e] / total_ops);
+            } else {
+                printf(",");  // Empty cell: counter not available
+            }
+        }
+    }
+    if (config->structure) {
+        printf(",%.2f,%.2f,%.1f", result->hops_before, result->hops_after,
+               result->structure.bytes_per_key);
+    }
+    if (config->rate > 0) {
+        printf(",%.2f", config->rate * config->num_threads);
+    }
+    if (config->per_thread) {
+        printf(",%.4f", result->fairness);
+    }
+    if (config->per_thread || config->rate > 0) {
+        printf(",%lu,%lu,%lu,%lu",
+               (unsigned long)hist_percentile(&result->latency, 50.0),
+               (unsigned long)hist_percentile(&result->latency, 99.0),
+               (unsigned long)hist_percentile(&result->latency, 99.9),
+               (unsigned long)result->latency.max);
+    }
+    if (config->oversubscribe > 0) {
+        printf(",%d,%s", config->cores, skiplock_policy_name(skiplock_policy));
+    }
+    if (config->dispatch_csv) {
+        printf(",%s", dispatch_names[config->dispatch]);
+    }
+    if (reader_writer_mode(config)) {
+        printf(",%d,%d", config->readers, config->writers);
+        for (int g = 0; g < NUM_GROUPS; g++) {
+            GroupResult* group = &result->groups[g];
+            printf(",%.2f,%lu,%lu", group->throughput,
+                   (unsigned long)hist_percentile(&group->latency, 50.0),
+                   (unsigned long)hist_percentile(&group->latency, 99.0));
+        }
+    }
+    if (config->memory_csv) {
+        MemoryReport* mem = &result->memory;
+        uint64_t outstanding = mem->nodes_allocated - mem->nodes_freed;
+        printf(",%lu,%lld,%lld,%ld,%.1f", (unsigned long)mem->nodes_allocated,
+               mem->live_nodes, mem->retired_nodes, mem->peak_rss_kb,
+               mem->live_nodes > 0 ? (double)outstanding * sizeof(Node) / mem->live_nodes : 0.0);
+    }
+    printf("\n");
 }
 
 void run_benchmark(BenchmarkConfig* config, bool csv_output) {
     SkipListOps ops = get_operations(config->impl);
+    MemoryStats memory_baseline;
+    skiplist_memory_stats(&memory_baseline);
     SkipList* list = ops.create();
     
     if (config->initial_size > 0) {
         prepopulate_list(list, &ops, config->initial_size, config->key_range);
     }
     
-    BenchmarkResult result;
+    if (config->perf) {
+        perf_session = perf_session_open(config->num_threads);
+    }
+    
+    // Sampled at quiescent points: coarse frees nodes, so a concurrent
+    // sampler would be unsafe there
+    double hops_before = 0.0;
+    if (config->structure) {
+        hops_before = skiplist_sample_hops(list, HOP_SAMPLES, config->key_range, 1);
+    }
+    
+    // Only count contention inside the timed region
+    skiplist_contention_reset();
+    skiplist_lock_profile_reset();
+    skiplist_trace_reset();
+    skiplist_metrics_reset();
+    
+    BenchmarkResult (*workload)(SkipList*, SkipListOps*, BenchmarkConfig*);
     
     if (strcmp(config->workload, "insert") == 0) {
-        result = run_insert_workload(list, &ops, config);
+        workload = run_insert_workload;
     } else if (strcmp(config->workload, "delete") == 0) {
-        result = run_delete_workload(list, &ops, config);
+        workload = run_delete_workload;
     } else if (strcmp(config->workload, "readonly") == 0) {
-        result = run_readonly_workload(list, &ops, config);
+        workload = run_readonly_workload;
     } else if (strcmp(config->workload, "mixed") == 0) {
-        result = run_mixed_workload(list, &ops, config);
+        workload = run_mixed_workload;
+    } else if (strcmp(config->workload, "readwrite") == 0) {
+        workload = run_readwrite_workload;
+    } else if (strcmp(config->workload, "pqueue") == 0) {
+        workload = run_pqueue_workload;
+    } else if (strcmp(config->workload, "pqueue_spray") == 0) {
+        workload = run_pqueue_spray_workload;
     } else {
         fprintf(stderr, "Unknown workload: %s\n", config->workload);
         ops.destroy(list);
         exit(1);
     }
     
+    pthread_t monitor;
+    MonitorArgs monitor_args = { config, list, &memory_baseline, csv_output ? stderr : stdout };
+    start_monitor(&monitor, &monitor_args);
+    
+    memset(thread_stats, 0, sizeof(ThreadStats) * config->num_threads);
+    
+    BenchmarkResult result = workload(list, &ops, config);
+    summarize_threads(config, &result);
+    
+    join_monitor(monitor, &monitor_args);
+    
+    collect_memory(list, &memory_baseline, &result.memory);
+    
+    if (config->metrics_path[0] != '\0') {
+        double snapshot_us = export_metrics(config, list);
+        fprintf(stderr, "Metrics written to %s (snapshot took %.1f us)\n",
+                config->metrics_path, snapshot_us);
+    }
+    
+    if (config->trace_path[0] != '\0') {
+        if (skiplist_trace_dump(config->trace_path)) {
+            fprintf(stderr, "Trace written to %s\n", config->trace_path);
+        } else {
+            fprintf(stderr, "Warning: no trace written (build with 'make trace')\n");
+        }
+    }
+    
+    if (config->structure) {
+        result.hops_before = hops_before;
+        result.hops_after = skiplist_sample_hops(list, HOP_SAMPLES, config->key_range, 1);
+        skiplist_stats(list, &result.structure);
+    }
+    
+    ValidationReport validation;
+    bool valid = true;
+    if (config->validate) {
+        valid = validate_skiplist_parallel(list, config->num_threads, &validation);
+        if (csv_output) {
+            fprintf(stderr, "Validation %s: %d keys, %d order/%d tower/%d height errors (%.3f s)\n",
+                    valid ? "ok" : "FAILED", validation.keys, validation.order_errors,
+                    validation.tower_errors, validation.height_errors, validation.seconds);
+        }
+    }
+    
+    perf_session_read(perf_session, &result.perf);
+    perf_session_close(perf_session);
+    perf_session = NULL;
+    
     if (csv_output) {
         print_csv_results(config, &result);
     } else {
         print_results(config, &result);
+        print_contention_stats(config, &result);
+        print_lock_profile(config, &result);
+        if (config->per_thread) {
+            print_thread_results(config, &result);
+        }
+        if (reader_writer_mode(config)) {
+            print_group_results(&result);
+        }
+        print_memory_results(&result);
+        if (config->structure) {
+            print_structure_results(&result);
+        }
+        if (config->validate) {
+            print_validation_report(&validation);
+        }
+    }
+    
+    ops.destroy(list);
+    if (!valid) {
+        exit(1);
+    }
+}
+
+// ------------------------------------------------------------------------
+// Phased scenarios: every phase runs on the same list, so effects that build
+// up over a list's lifetime (retired nodes after a drain, a degraded level
+// distribution) carry into the next phase.
+// ------------------------------------------------------------------------
+static void print_phase_header(bool csv_output) {
+    if (csv_output) {
+        printf("phase,impl,threads,insert_pct,delete_pct,scan,ops,time,throughput,successful,failed,"
+               "p50_ns,p99_ns,p999_ns,live_nodes,retired_nodes,node_bytes,rss_kb,peak_rss_kb\n");
+    } else {
+        printf("%-14s %7s %10s %8s %13s %7s %8s %8s %10s %10s %9s %8s\n",
+               "phase", "threads", "ops", "time(s)", "ops/sec", "ok%", "p50(ns)", "p99(ns)",
+               "live", "retired", "nodes(MB)", "RSS(MB)");
+    }
+}
+
+static void print_phase_result(BenchmarkConfig* config, ScenarioPhase* phase,
+                               BenchmarkResult* result, bool csv_output) {
+    MemoryReport* mem = &result->memory;
+    uint64_t node_bytes = (mem->nodes_allocated - mem->nodes_freed) * sizeof(Node);
+    
+    if (csv_output) {
+        printf("%s,%s,%d,%d,%d,%d,%lld,%.4f,%.2f,%lld,%lld,%lu,%lu,%lu,%lld,%lld,%lu,%ld,%ld\n",
+               phase->name, config->impl, phase->threads, phase->insert_percent,
+               phase->delete_percent, phase->scan_length, result->total_ops, result->total_time,
+               result->throughput, result->successful_ops, result->failed_ops,
+               (unsigned long)hist_percentile(&result->latency, 50.0),
+               (unsigned long)hist_percentile(&result->latency, 99.0),
+               (unsigned long)hist_percentile(&result->latency, 99.9),
+               mem->live_nodes, mem->retired_nodes, (unsigned long)node_bytes,
+               current_rss_kb(), mem->peak_rss_kb);
+    } else {
+        printf("%-14s %7d %10lld %8.3f %13.2f %6.1f%% %8lu %8lu %10lld %10lld %9.1f %8.1f\n",
+               phase->name, phase->threads, result->total_ops, result->total_time,
+               result->throughput,
+               result->total_ops > 0 ? 100.0 * result->successful_ops / result->total_ops : 0.0,
+               (unsigned long)hist_percentile(&result->latency, 50.0),
+               (unsigned long)hist_percentile(&result->latency, 99.0),
+               mem->live_nodes, mem->retired_nodes, node_bytes / (1024.0 * 1024.0),
+               current_rss_kb() / 1024.0);
+    }
+    fflush(stdout);
+}
+
+void run_scenario(BenchmarkConfig* config, bool csv_output) {
+    ScenarioPhase phases[SCENARIO_MAX_PHASES];
+    int num_phases = scenario_load(config->scenario_path, phases, SCENARIO_MAX_PHASES,
+                                   MAX_BENCH_THREADS);
+    if (num_phases < 0) exit(1);
+    
+    SkipListOps ops = get_operations(config->impl);
+    MemoryStats memory_baseline;
+    skiplist_memory_stats(&memory_baseline);
+    SkipList* list = ops.create();
+    
+    if (config->initial_size > 0) {
+        prepopulate_list(list, &ops, config->initial_size, config->key_range);
+    }
+    
+    if (!csv_output) {
+        printf("\n=== Scenario: %s (%s, key range %d, %d phases) ===\n",
+               config->scenario_path, config->impl, config->key_range, num_phases);
+    }
+    print_phase_header(csv_output);
+    
+    for (int p = 0; p < num_phases; p++) {
+        ScenarioPhase* phase = &phases[p];
+        BenchmarkConfig phase_config = *config;
+        phase_config.num_threads = phase->threads;
+        phase_config.ops_per_thread = (int)phase->ops_per_thread;
+        phase_config.duration = phase->duration;
+        phase_config.insert_percent = phase->insert_percent;
+        phase_config.delete_percent = phase->delete_percent;
+        phase_config.per_thread = true;  // Time every op for the phase percentiles
+        
+        WorkloadMix mix = { phase->insert_percent, phase->delete_percent, true,
+                            45678 + p, phase->scan_length };
+        
+        pthread_t monitor;
+        MonitorArgs monitor_args = { &phase_config, list, &memory_baseline, csv_output ? stderr : stdout };
+        start_monitor(&monitor, &monitor_args);
+        
+        memset(thread_stats, 0, sizeof(ThreadStats) * phase_config.num_threads);
+        
+        BenchmarkResult result = run_workload(list, &ops, &phase_config,
+                                              (WorkloadMix[NUM_GROUPS]){ mix, mix });
+        summarize_threads(&phase_config, &result);
+        
+        join_monitor(monitor, &monitor_args);
+        
+        collect_memory(list, &memory_baseline, &result.memory);
+        print_phase_result(config, phase, &result, csv_output);
+    }
+    
+    if (!csv_output) {
+        printf("\n");
     }
     
     ops.destroy(list);
@@ -251,15 +1035,49 @@ void run_benchmark(BenchmarkConfig* config, bool csv_output) {
 void print_usage(const char* prog) {
     printf("Usage: %s [OPTIONS]\n", prog);
     printf("Options:\n");
-    printf("  --impl <type>        Implementation: coarse, fine, lockfree (default: lockfree)\n");
+    printf("  --impl <type>        Implementation: coarse, fine, lockfree (default: lockfree),\n");
+    printf("                       or a baseline: avl, hash, btree\n");
     printf("  --threads <n>        Number of threads (default: 4)\n");
     printf("  --ops <n>            Operations per thread (default: 100000)\n");
     printf("  --key-range <n>      Range of keys (default: 10000)\n");
-    printf("  --workload <type>    Workload: insert, delete, readonly, mixed (default: mixed)\n");
-    printf("  --insert-pct <n>     Insert percentage for mixed (default: 30)\n");
+    printf("  --workload <type>    Workload: insert, delete, readonly, mixed (default: mixed),\n");
+    printf("                       pqueue (insert vs. pop_min, lockfree only),\n");
+    printf("                       pqueue_spray (insert vs. SprayList pop_approx_min)\n");
+    printf("  --insert-pct <n>     Insert percentage for mixed (default: 30; pqueue: 50,\n");
+    printf("                       the rest are pops)\n");
     printf("  --delete-pct <n>     Delete percentage for mixed (default: 20)\n");
     printf("  --initial-size <n>   Pre-populate list (default: 0)\n");
     printf("  --warmup <n>         Warmup operations (default: 1000)\n");
+    printf("  --perf               Collect hardware counters (cycles, instructions,\n");
+    printf("                       LLC/dTLB/branch misses) and report per-op counts\n");
+    printf("  --structure          Report level histogram, search path length and\n");
+    printf("                       bytes/key; sample avg hops before and after the run\n");
+    printf("  --validate           Check order, towers and size after the run (parallel,\n");
+    printf("                       --threads threads); exit 1 if the list is corrupt\n");
+    printf("  --duration <sec>     Run for a fixed time instead of --ops per thread\n");
+    printf("  --interval <sec>     Throughput/memory report period in duration mode\n");
+    printf("  --memory             Append memory columns to CSV output\n");
+    printf("  --trace <file>       Write Chrome/Perfetto trace JSON (needs 'make trace')\n");
+    printf("  --per-thread         Per-thread ops, completion time, latency percentiles\n");
+    printf("                       and Jain's fairness index (times every op)\n");
+    printf("  --rate <ops/sec>     Open loop: each thread issues ops on a fixed schedule;\n");
+    printf("                       latency is measured from the intended start time\n");
+    printf("  --readers <n>        Reader threads; with --writers selects the readwrite\n");
+    printf("                       workload and replaces --threads\n");
+    printf("  --writers <n>        Dedicated writer threads\n");
+    printf("  --reader-mix <i:d>   Reader insert:delete percentages (default: 0:0)\n");
+    printf("  --writer-mix <i:d>   Writer insert:delete percentages (default: 50:50)\n");
+    printf("  --scenario <file>    Run the phases in <file> on one list and report each\n");
+    printf("                       phase (see scenarios/lifecycle.txt)\n");
+    printf("  --lock-policy <p>    Coarse/fine lock waiting: park (spin, then sleep on a\n");
+    printf("                       futex; default), spin (never sleep) or omp (omp_lock_t,\n");
+    printf("                       the lock used before the futex lock existed)\n");
+    printf("  --oversubscribe <f>  Use f x online cores threads (e.g. 4); overrides --threads\n");
+    printf("  --dispatch <mode>    direct: per-implementation driver calling the ops\n");
+    printf("                       directly (default); indirect: via function pointers\n");
+    printf("                       (not for the pqueue workloads)\n");
+    printf("  --metrics <file>     Write Prometheus text metrics at the end of the run\n");
+    printf("                       (and every --interval in duration mode)\n");
     printf("  --csv                Output in CSV format\n");
     printf("  --help               Show this help message\n");
 }
@@ -275,13 +1093,35 @@ int main(int argc, char* argv[]) {
         .delete_percent = 20,
         .search_percent = 50,
         .initial_size = 0,
-        .warmup_ops = 1000
+        .warmup_ops = 1000,
+        .perf = false,
+        .structure = false,
+        .validate = false,
+        .duration = 0.0,
+        .interval = 0.0,
+        .memory_csv = false,
+        .trace_path = "",
+        .metrics_path = "",
+        .per_thread = false,
+        .rate = 0.0,
+        .readers = 0,
+        .writers = 0,
+        .reader_insert_percent = 0,
+        .reader_delete_percent = 0,
+        .writer_insert_percent = 50,
+        .writer_delete_percent = 50,
+        .scenario_path = "",
+        .oversubscribe = 0.0,
+        .cores = 0,
+        .dispatch = DISPATCH_DIRECT,
+        .dispatch_csv = false
     };
     
     strcpy(config.impl, "lockfree");
     strcpy(config.workload, "mixed");
     
     bool csv_output = false;
+    bool insert_percent_set = false;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--impl") == 0 && i + 1 < argc) {
@@ -296,12 +1136,71 @@ int main(int argc, char* argv[]) {
             strcpy(config.workload, argv[++i]);
         } else if (strcmp(argv[i], "--insert-pct") == 0 && i + 1 < argc) {
             config.insert_percent = atoi(argv[++i]);
+            insert_percent_set = true;
         } else if (strcmp(argv[i], "--delete-pct") == 0 && i + 1 < argc) {
             config.delete_percent = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--initial-size") == 0 && i + 1 < argc) {
             config.initial_size = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
             config.warmup_ops = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            config.perf = true;
+        } else if (strcmp(argv[i], "--structure") == 0) {
+            config.structure = true;
+        } else if (strcmp(argv[i], "--validate") == 0) {
+            config.validate = true;
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            config.duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            config.interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--memory") == 0) {
+            config.memory_csv = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            snprintf(config.trace_path, sizeof(config.trace_path), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            config.rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--per-thread") == 0) {
+            config.per_thread = true;
+        } else if (strcmp(argv[i], "--readers") == 0 && i + 1 < argc) {
+            config.readers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--writers") == 0 && i + 1 < argc) {
+            config.writers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--reader-mix") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d:%d", &config.reader_insert_percent,
+                       &config.reader_delete_percent) != 2) {
+                fprintf(stderr, "--reader-mix expects <insert>:<delete>\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--writer-mix") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d:%d", &config.writer_insert_percent,
+                       &config.writer_delete_percent) != 2) {
+                fprintf(stderr, "--writer-mix expects <insert>:<delete>\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            snprintf(config.scenario_path, sizeof(config.scenario_path), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--lock-policy") == 0 && i + 1 < argc) {
+            LockPolicy policy;
+            if (!skiplock_parse_policy(argv[++i], &policy)) {
+                fprintf(stderr, "Unknown lock policy: %s (use park, spin or omp)\n", argv[i]);
+                return 1;
+            }
+            skiplock_set_policy(policy);
+        } else if (strcmp(argv[i], "--oversubscribe") == 0 && i + 1 < argc) {
+            config.oversubscribe = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--dispatch") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "direct") == 0) {
+                config.dispatch = DISPATCH_DIRECT;
+            } else if (strcmp(argv[i], "indirect") == 0) {
+                config.dispatch = DISPATCH_INDIRECT;
+            } else {
+                fprintf(stderr, "Unknown dispatch mode: %s (use direct or indirect)\n", argv[i]);
+                return 1;
+            }
+            config.dispatch_csv = true;
+        } else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            snprintf(config.metrics_path, sizeof(config.metrics_path), "%s", argv[++i]);
         } else if (strcmp(argv[i], "--csv") == 0) {
             csv_output = true;
         } else if (strcmp(argv[i], "--help") == 0) {
@@ -310,10 +1209,69 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (strncmp(config.workload, "pqueue", 6) == 0) {
+        if (strcmp(config.impl, "lockfree") != 0) {
+            fprintf(stderr, "The pqueue workload needs pop_min, which only lockfree has\n");
+            return 1;
+        }
+        if (config.dispatch == DISPATCH_INDIRECT) {
+            fprintf(stderr, "The pqueue workloads have no indirect driver; use --dispatch direct\n");
+            return 1;
+        }
+        if (!insert_percent_set) config.insert_percent = 50;
+        if (config.insert_percent < 0 || config.insert_percent > 100) {
+            fprintf(stderr, "--insert-pct must be 0..100\n");
+            return 1;
+        }
+        config.delete_percent = 100 - config.insert_percent;
+    }
     config.search_percent = 100 - config.insert_percent - config.delete_percent;
     
+    if (config.structure && !is_skiplist_impl(config.impl)) {
+        fprintf(stderr, "Warning: --structure only applies to skip lists; ignored for %s\n", config.impl);
+        config.structure = false;
+    }
+    if (config.validate && !is_skiplist_impl(config.impl)) {
+        fprintf(stderr, "Warning: --validate only applies to skip lists; ignored for %s\n", config.impl);
+        config.validate = false;
+    }
+    
+    if (config.readers < 0 || config.writers < 0) {
+        fprintf(stderr, "--readers and --writers must not be negative\n");
+        return 1;
+    }
+    if (config.reader_insert_percent < 0 || config.reader_delete_percent < 0 ||
+        config.reader_insert_percent + config.reader_delete_percent > 100) {
+        fprintf(stderr, "--reader-mix: insert + delete must be 0..100\n");
+        return 1;
+    }
+    if (config.writer_insert_percent < 0 || config.writer_delete_percent < 0 ||
+        config.writer_insert_percent + config.writer_delete_percent > 100) {
+        fprintf(stderr, "--writer-mix: insert + delete must be 0..100\n");
+        return 1;
+    }
+    if (config.oversubscribe > 0) {
+        config.cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        config.num_threads = (int)(config.oversubscribe * config.cores + 0.5);
+        if (config.num_threads < 1) config.num_threads = 1;
+    }
+    if (reader_writer_mode(&config)) {
+        config.num_threads = config.readers + config.writers;
+        strcpy(config.workload, "readwrite");
+    }
+    
+    if (config.num_threads < 1 || config.num_threads > MAX_BENCH_THREADS) {
+        fprintf(stderr, "--threads must be between 1 and %d\n", MAX_BENCH_THREADS);
+        return 1;
+    }
+    
+    if (config.scenario_path[0] != '\0') {
+        run_scenario(&config, csv_output);
+        return 0;
+    }
+    
     if (csv_output) {
-        print_csv_header();
+        print_csv_header(&config);
     }
     
     run_benchmark(&config, csv_output);
@@ -0,0 +1,39 @@
+#include "latency_hist.h"
+#include <string.h>
+
+void hist_reset(LatencyHistogram* h) {
+    memset(h, 0, sizeof(*h));
+}
+
+void hist_merge(LatencyHistogram* into, const LatencyHistogram* from) {
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        into->counts[b] += from->counts[b];
+    }
+    into->total += from->total;
+    if (from->max > into->max) into->max = from->max;
+}
+
+static uint64_t bucket_upper_bound(int bucket) {
+    if (bucket < HIST_SUB_BUCKETS) return (uint64_t)bucket;
+    int shift = bucket / HIST_SUB_BUCKETS - 1;
+    int sub = bucket % HIST_SUB_BUCKETS;
+    return (((uint64_t)(HIST_SUB_BUCKETS + sub + 1)) << shift) - 1;
+}
+
+uint64_t hist_percentile(const LatencyHistogram* h, double percentile) {
+    if (h->total == 0) return 0;
+    
+    uint64_t rank = (uint64_t)(percentile / 100.0 * h->total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->total) rank = h->total;
+    
+    uint64_t seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            uint64_t bound = bucket_upper_bound(b);
+            return bound < h->max ? bound : h->max;
+        }
+    }
+    return h->max;
+}
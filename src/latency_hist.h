@@ -0,0 +1,54 @@
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Log-linear latency histogram (HDR-style)
+ *
+ * Values below 16ns get exact buckets; above that every power of two is
+ * split into 16 linear sub-buckets, so any recorded value is reported with
+ * at most ~6% relative error. Values are clamped at 2^HIST_MAX_SHIFT ns.
+ * One histogram per thread; merge them after the run.
+ */
+
+#define HIST_SUB_BITS 4
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_MAX_SHIFT 40                      // ~18 minutes
+#define HIST_BUCKETS ((HIST_MAX_SHIFT - HIST_SUB_BITS + 2) * HIST_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+} LatencyHistogram;
+
+static inline uint64_t hist_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline int hist_bucket(uint64_t ns) {
+    if (ns < HIST_SUB_BUCKETS) return (int)ns;
+    int msb = 63 - __builtin_clzll(ns);
+    if (msb >= HIST_MAX_SHIFT) return HIST_BUCKETS - 1;
+    int shift = msb - HIST_SUB_BITS;
+    int sub = (int)((ns >> shift) & (HIST_SUB_BUCKETS - 1));
+    return (shift + 1) * HIST_SUB_BUCKETS + sub;
+}
+
+static inline void hist_record(LatencyHistogram* h, uint64_t ns) {
+    h->counts[hist_bucket(ns)]++;
+    h->total++;
+    if (ns > h->max) h->max = ns;
+}
+
+void hist_reset(LatencyHistogram* h);
+void hist_merge(LatencyHistogram* into, const LatencyHistogram* from);
+
+// Upper bound of the bucket holding the given percentile (0-100), in ns
+uint64_t hist_percentile(const LatencyHistogram* h, double percentile);
+
+#endif // LATENCY_HIST_H
@@ -0,0 +1,411 @@
+#include "skiplist_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <omp.h>
+
+/**
+ * Hot-Path Microbenchmarks
+ *
+ * Times individual primitives in isolation so that a change in
+ * bin/benchmark throughput can be traced back to the piece that moved:
+ * random_level, create_node/free_node, a single search descent per variant
+ * at several list sizes (plus rank/select descents), CAS on a hot vs. a cold cache line, and each
+ * backoff() step. Every case is a tight loop timed as a whole with the TSC
+ * (x86) or CLOCK_MONOTONIC elsewhere; the median of --reps runs is shown.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TICK_UNIT "tsc"
+// lfence keeps rdtsc from being reordered with the timed loop
+static inline uint64_t ticks_begin(void) {
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+static inline uint64_t ticks_end(void) {
+    unsigned int aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+#else
+#define TICK_UNIT "ns"
+static inline uint64_t ticks_begin(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+static inline uint64_t ticks_end(void) {
+    return ticks_begin();
+}
+#endif
+
+#define MAX_REPS 101
+#define CAS_COLD_BYTES (256ull << 20)   // Well beyond any LLC
+#define FIND_LOOKUPS 1000000
+
+typedef struct {
+    int reps;
+    int max_size;
+    int threads;
+    const char* filter;
+    bool csv;
+} MicroConfig;
+
+static double ticks_per_ns = 1.0;
+static volatile uint64_t sink;  // Keeps results of timed loops alive
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void calibrate_ticks(void) {
+    double t0 = now_ns();
+    uint64_t k0 = ticks_begin();
+    struct timespec pause = { 0, 100000000 };
+    nanosleep(&pause, NULL);
+    uint64_t k1 = ticks_end();
+    double t1 = now_ns();
+    ticks_per_ns = (k1 - k0) / (t1 - t0);
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void print_header(MicroConfig* config) {
+    if (config->csv) {
+        printf("primitive,param,ops,ns_per_op,ticks_per_op,min_ns_per_op\n");
+    } else {
+        printf("Timer: %s, %.3f ticks/ns, median of %d runs\n\n", TICK_UNIT, ticks_per_ns, config->reps);
+        printf("%-22s %-14s %10s %10s %12s %10s\n",
+               "primitive", "param", "ops", "ns/op", TICK_UNIT "/op", "min ns/op");
+    }
+}
+
+static void report(MicroConfig* config, const char* name, const char* param,
+                   uint64_t ops, uint64_t* ticks, int reps) {
+    qsort(ticks, reps, sizeof(uint64_t), compare_u64);
+    double median = (double)ticks[reps / 2] / ops;
+    double min = (double)ticks[0] / ops;
+    if (config->csv) {
+        printf("%s,%s,%lu,%.3f,%.2f,%.3f\n", name, param, (unsigned long)ops,
+               median / ticks_per_ns, median, min / ticks_per_ns);
+    } else {
+        printf("%-22s %-14s %10lu %10.2f %12.1f %10.2f\n", name, param, (unsigned long)ops,
+               median / ticks_per_ns, median, min / ticks_per_ns);
+    }
+    fflush(stdout);
+}
+
+static bool selected(MicroConfig* config, const char* name) {
+    return config->filter == NULL || strstr(name, config->filter) != NULL;
+}
+
+// ------------------------------------------------------------------------
+// random_level / create_node
+// ------------------------------------------------------------------------
+static void bench_random_level(MicroConfig* config) {
+    const uint64_t ops = 10000000;
+    uint64_t ticks[MAX_REPS];
+    for (int r = 0; r < config->reps; r++) {
+        uint64_t sum = 0;
+        uint64_t start = ticks_begin();
+        for (uint64_t i = 0; i < ops; i++) {
+            sum += random_level();
+        }
+        ticks[r] = ticks_end() - start;
+        sink = sum;
+    }
+    report(config, "random_level", "-", ops, ticks, config->reps);
+}
+
+static void bench_create_node(MicroConfig* config) {
+    const uint64_t ops = 1000000;
+    Node** nodes = (Node**)malloc(ops * sizeof(Node*));
+    uint64_t create_ticks[MAX_REPS], free_ticks[MAX_REPS];
+
+    for (int r = 0; r < config->reps; r++) {
+        uint64_t start = ticks_begin();
+        for (uint64_t i = 0; i < ops; i++) {
+            nodes[i] = create_node((int)i, (int)i, (int)(i & 3));
+        }
+        create_ticks[r] = ticks_end() - start;
+
+        start = ticks_begin();
+        for (uint64_t i = 0; i < ops; i++) {
+            free_node(nodes[i]);
+        }
+        free_ticks[r] = ticks_end() - start;
+    }
+    free(nodes);
+    report(config, "create_node", "batch", ops, create_ticks, config->reps);
+    report(config, "free_node", "batch", ops, free_ticks, config->reps);
+}
+
+// ------------------------------------------------------------------------
+// Search descents: one contains() (and the lock-free helping find()) on a
+// list of n keys; half of the lookups hit
+// ------------------------------------------------------------------------
+typedef struct {
+    const char* name;
+    SkipList* (*create)(void);
+    bool (*insert)(SkipList*, int, int);
+    bool (*lookup)(SkipList*, int);
+    void (*destroy)(SkipList*);
+    void (*prepare)(SkipList*);   // Optional, after the inserts
+    void (*release)(SkipList*);   // Optional, before destroy
+} DescentCase;
+
+// Order-statistic descents as lookups: select takes key / 2 as its index,
+// which stays below n
+static bool rank_indexed(SkipList* list, int key) {
+    return skiplist_rank_coarse(list, key) > 0;
+}
+
+static bool select_indexed(SkipList* list, int key) {
+    int found;
+    return skiplist_select_coarse(list, key / 2, &found);
+}
+
+static RankSample bench_sample;
+
+static void take_sample(SkipList* list) {
+    skiplist_rank_sample(list, &bench_sample, 1024);
+}
+
+static void drop_sample(SkipList* list) {
+    (void)list;
+    free_rank_sample(&bench_sample);
+}
+
+static bool rank_estimate(SkipList* list, int key) {
+    return skiplist_rank_estimate(list, &bench_sample, key) > 0;
+}
+
+static bool select_estimate(SkipList* list, int key) {
+    int found;
+    return skiplist_select_estimate(list, &bench_sample, key / 2, &found);
+}
+
+static const DescentCase descent_cases[] = {
+    { "contains_coarse", skiplist_create_coarse, skiplist_insert_coarse,
+      skiplist_contains_coarse, skiplist_destroy_coarse, NULL, NULL },
+    { "contains_fine", skiplist_create_fine, skiplist_insert_fine,
+      skiplist_contains_fine, skiplist_destroy_fine, NULL, NULL },
+    { "contains_lockfree", skiplist_create_lockfree, skiplist_insert_lockfree,
+      skiplist_contains_lockfree, skiplist_destroy_lockfree, NULL, NULL },
+    { "find_lockfree", skiplist_create_lockfree, skiplist_insert_lockfree,
+      skiplist_find_lockfree, skiplist_destroy_lockfree, NULL, NULL },
+    { "rank_indexed", skiplist_create_coarse_indexable, skiplist_insert_coarse,
+      rank_indexed, skiplist_destroy_coarse, NULL, NULL },
+    { "select_indexed", skiplist_create_coarse_indexable, skiplist_insert_coarse,
+      select_indexed, skiplist_destroy_coarse, NULL, NULL },
+    { "rank_estimate", skiplist_create_lockfree, skiplist_insert_lockfree,
+      rank_estimate, skiplist_destroy_lockfree, take_sample, drop_sample },
+    { "select_estimate", skiplist_create_lockfree, skiplist_insert_lockfree,
+      select_estimate, skiplist_destroy_lockfree, take_sample, drop_sample },
+};
+
+static void bench_descents(MicroConfig* config) {
+    int* keys = (int*)malloc(FIND_LOOKUPS * sizeof(int));
+
+    for (size_t c = 0; c < sizeof(descent_cases) / sizeof(descent_cases[0]); c++) {
+        const DescentCase* dc = &descent_cases[c];
+        if (!selected(config, dc->name)) continue;
+
+        for (int n = 1000; n <= config->max_size; n *= 10) {
+            // Even keys 0..2n-2 inserted in shuffled order
+            int* order = (int*)malloc(n * sizeof(int));
+            for (int i = 0; i < n; i++) order[i] = 2 * i;
+            unsigned int seed = 42;
+            for (int i = n - 1; i > 0; i--) {
+                int j = rand_r(&seed) % (i + 1);
+                int tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+            }
+            SkipList* list = dc->create();
+            for (int i = 0; i < n; i++) dc->insert(list, order[i], order[i]);
+            free(order);
+            if (dc->prepare) dc->prepare(list);
+
+            for (int i = 0; i < FIND_LOOKUPS; i++) keys[i] = rand_r(&seed) % (2 * n);
+
+            uint64_t ticks[MAX_REPS];
+            for (int r = 0; r < config->reps; r++) {
+                uint64_t hits = 0;
+                uint64_t start = ticks_begin();
+                for (int i = 0; i < FIND_LOOKUPS; i++) {
+                    hits += dc->lookup(list, keys[i]);
+                }
+                ticks[r] = ticks_end() - start;
+                sink = hits;
+            }
+            char param[32];
+            snprintf(param, sizeof(param), "n=%d", n);
+            report(config, dc->name, param, FIND_LOOKUPS, ticks, config->reps);
+            if (dc->release) dc->release(list);
+            dc->destroy(list);
+        }
+    }
+    free(keys);
+}
+
+// ------------------------------------------------------------------------
+// CAS: one line in L1, one line shared by several threads, and random
+// lines of a buffer far larger than the LLC
+// ------------------------------------------------------------------------
+typedef struct {
+    _Atomic(uint64_t) value;
+} __attribute__((aligned(CACHE_LINE_SIZE))) PaddedWord;
+
+// Returns the value replaced
+static inline uint64_t cas_increment(_Atomic(uint64_t)* word) {
+    uint64_t expected = atomic_load_explicit(word, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak(word, &expected, expected + 1)) {
+    }
+    return expected;
+}
+
+static void bench_cas(MicroConfig* config) {
+    const uint64_t ops = 10000000;
+    uint64_t ticks[MAX_REPS];
+    static PaddedWord hot;
+
+    if (selected(config, "cas_hot")) {
+        for (int r = 0; r < config->reps; r++) {
+            uint64_t start = ticks_begin();
+            for (uint64_t i = 0; i < ops; i++) {
+                cas_increment(&hot.value);
+            }
+            ticks[r] = ticks_end() - start;
+        }
+        report(config, "cas_hot", "1 thread", ops, ticks, config->reps);
+    }
+
+    if (selected(config, "cas_shared") && config->threads > 1) {
+        // Per-thread ops; ns/op is per CAS as seen by one thread
+        for (int r = 0; r < config->reps; r++) {
+            uint64_t max_ticks = 0;
+            #pragma omp parallel num_threads(config->threads) reduction(max:max_ticks)
+            {
+                #pragma omp barrier
+                uint64_t start = ticks_begin();
+                for (uint64_t i = 0; i < ops / 10; i++) {
+                    cas_increment(&hot.value);
+                }
+                max_ticks = ticks_end() - start;
+            }
+            ticks[r] = max_ticks;
+        }
+        char param[32];
+        snprintf(param, sizeof(param), "%d threads", config->threads);
+        report(config, "cas_shared", param, ops / 10, ticks, config->reps);
+    }
+
+    if (selected(config, "cas_cold")) {
+        size_t lines = CAS_COLD_BYTES / sizeof(PaddedWord);
+        PaddedWord* buffer = (PaddedWord*)aligned_alloc(CACHE_LINE_SIZE, lines * sizeof(PaddedWord));
+        if (!buffer) {
+            fprintf(stderr, "cas_cold: cannot allocate %llu MB, skipped\n", CAS_COLD_BYTES >> 20);
+            return;
+        }
+        memset(buffer, 0, lines * sizeof(PaddedWord));  // Fault the pages in first
+
+        // Random line order from an LCG so the prefetcher can't follow. Each
+        // index depends on the previous CAS result, so misses can't overlap.
+        const uint64_t cold_ops = 2000000;
+        for (int r = 0; r < config->reps; r++) {
+            uint64_t x = 12345 + r;
+            uint64_t start = ticks_begin();
+            for (uint64_t i = 0; i < cold_ops; i++) {
+                x = x * 6364136223846793005ull + 1442695040888963407ull;
+                x ^= cas_increment(&buffer[(x >> 33) % lines].value) & 1;
+            }
+            ticks[r] = ticks_end() - start;
+        }
+        report(config, "cas_cold", "256MB random", cold_ops, ticks, config->reps);
+        free(buffer);
+    }
+}
+
+// ------------------------------------------------------------------------
+// backoff(): the call at each attempt level (the last one yields)
+// ------------------------------------------------------------------------
+static void bench_backoff(MicroConfig* config) {
+    const uint64_t ops = 200000;
+    uint64_t ticks[MAX_REPS];
+    for (int level = 1; level <= 4; level++) {
+        for (int r = 0; r < config->reps; r++) {
+            uint64_t start = ticks_begin();
+            for (uint64_t i = 0; i < ops; i++) {
+                int attempt = level - 1;
+                skiplist_backoff_lockfree(&attempt);
+            }
+            ticks[r] = ticks_end() - start;
+        }
+        char param[32];
+        snprintf(param, sizeof(param), "attempt=%d", level);
+        report(config, "backoff", param, ops, ticks, config->reps);
+    }
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [OPTIONS]\n", prog);
+    printf("Options:\n");
+    printf("  --reps <n>           Runs per case, median reported (default: 5)\n");
+    printf("  --max-size <n>       Largest list for the descent cases (default: 1000000)\n");
+    printf("  --threads <n>        Threads for cas_shared (default: online cores, min 2)\n");
+    printf("  --filter <text>      Only run primitives whose name contains <text>\n");
+    printf("  --csv                Output in CSV format\n");
+    printf("  --help               Show this help message\n");
+}
+
+int main(int argc, char* argv[]) {
+    MicroConfig config = {
+        .reps = 5,
+        .max_size = 1000000,
+        .threads = omp_get_num_procs() > 1 ? omp_get_num_procs() : 2,
+        .filter = NULL,
+        .csv = false
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            config.reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+            config.max_size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            config.filter = argv[++i];
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            config.csv = true;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+
+    if (config.reps < 1 || config.reps > MAX_REPS) {
+        fprintf(stderr, "--reps must be between 1 and %d\n", MAX_REPS);
+        return 1;
+    }
+
+    calibrate_ticks();
+    print_header(&config);
+
+    if (selected(&config, "random_level")) bench_random_level(&config);
+    if (selected(&config, "create_node") || selected(&config, "free_node")) bench_create_node(&config);
+    bench_descents(&config);
+    bench_cas(&config);
+    if (selected(&config, "backoff")) bench_backoff(&config);
+
+    return 0;
+}
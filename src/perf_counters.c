@@ -0,0 +1,168 @@
+#include "perf_counters.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <omp.h>
+
+struct PerfSession {
+    int num_threads;
+    int (*fds)[PERF_NUM_EVENTS];   // fds[thread][event], -1 if not open
+    bool valid[PERF_NUM_EVENTS];
+};
+
+typedef struct {
+    uint32_t type;
+    uint64_t config;
+} PerfEventSpec;
+
+#define HW_CACHE_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const PerfEventSpec event_specs[PERF_NUM_EVENTS] = {
+    [PERF_CYCLES]        = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [PERF_INSTRUCTIONS]  = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [PERF_LLC_MISSES]    = { PERF_TYPE_HW_CACHE, HW_CACHE_MISS(PERF_COUNT_HW_CACHE_LL) },
+    [PERF_DTLB_MISSES]   = { PERF_TYPE_HW_CACHE, HW_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB) },
+    [PERF_BRANCH_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+static const char* event_names[PERF_NUM_EVENTS] = {
+    [PERF_CYCLES]        = "cycles",
+    [PERF_INSTRUCTIONS]  = "instructions",
+    [PERF_LLC_MISSES]    = "llc_misses",
+    [PERF_DTLB_MISSES]   = "dtlb_misses",
+    [PERF_BRANCH_MISSES] = "branch_misses",
+};
+
+const char* perf_event_name(PerfEvent event) {
+    return event_names[event];
+}
+
+// Counts the calling thread only (pid = 0, cpu = -1), user space only so
+// that perf_event_paranoid = 2 (the common distro default) still works.
+static int open_counter(const PerfEventSpec* spec) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec->type;
+    attr.config = spec->config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfSession* perf_session_open(int num_threads) {
+    PerfSession* session = (PerfSession*)calloc(1, sizeof(PerfSession));
+    if (!session) return NULL;
+
+    session->num_threads = num_threads;
+    session->fds = calloc(num_threads, sizeof(*session->fds));
+    if (!session->fds) {
+        free(session);
+        return NULL;
+    }
+    for (int t = 0; t < num_threads; t++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            session->fds[t][e] = -1;
+        }
+    }
+
+    // Probe each event on this thread; the workers open their own counters
+    // in perf_thread_start
+    bool any_valid = false;
+    int first_errno = 0;
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        int fd = open_counter(&event_specs[e]);
+        session->valid[e] = fd >= 0;
+        if (fd >= 0) {
+            close(fd);
+            any_valid = true;
+        } else if (first_errno == 0) {
+            first_errno = errno;
+        }
+    }
+
+    if (!any_valid) {
+        fprintf(stderr, "Warning: hardware counters unavailable (%s); "
+                "check /proc/sys/kernel/perf_event_paranoid. Continuing without --perf.\n",
+                strerror(first_errno));
+        perf_session_close(session);
+        return NULL;
+    }
+
+    return session;
+}
+
+// Opens the counters on the calling thread itself (pid = 0), so they count
+// the thread that runs the workload whichever pool thread OpenMP hands out.
+// An event is only reported if every thread could count it.
+void perf_thread_start(PerfSession* session) {
+    if (!session) return;
+    int tid = omp_get_thread_num();
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        if (!__atomic_load_n(&session->valid[e], __ATOMIC_RELAXED)) continue;
+        if (session->fds[tid][e] >= 0) close(session->fds[tid][e]);  // Earlier timed region
+        int fd = open_counter(&event_specs[e]);
+        session->fds[tid][e] = fd;
+        if (fd < 0) {
+            __atomic_store_n(&session->valid[e], false, __ATOMIC_RELAXED);
+            continue;
+        }
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perf_thread_stop(PerfSession* session) {
+    if (!session) return;
+    int tid = omp_get_thread_num();
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        int fd = session->fds[tid][e];
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+void perf_session_read(PerfSession* session, PerfTotals* totals) {
+    memset(totals, 0, sizeof(*totals));
+    if (!session) return;
+
+    for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+        totals->valid[e] = session->valid[e];
+        if (!session->valid[e]) continue;
+
+        for (int t = 0; t < session->num_threads; t++) {
+            uint64_t buf[3];  // value, time_enabled, time_running
+            if (session->fds[t][e] < 0) continue;  // Thread never ran the workload
+            if (read(session->fds[t][e], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) {
+                totals->valid[e] = false;
+                break;
+            }
+            // Scale up if the PMU was multiplexed between events
+            uint64_t value = buf[0];
+            if (buf[2] > 0 && buf[2] < buf[1]) {
+                value = (uint64_t)((double)value * buf[1] / buf[2]);
+            }
+            totals->values[e] += value;
+        }
+    }
+}
+
+void perf_session_close(PerfSession* session) {
+    if (!session) return;
+    for (int t = 0; t < session->num_threads; t++) {
+        for (int e = 0; e < PERF_NUM_EVENTS; e++) {
+            if (session->fds[t][e] >= 0) close(session->fds[t][e]);
+        }
+    }
+    free(session->fds);
+    free(session);
+}
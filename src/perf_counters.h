@@ -0,0 +1,48 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Hardware Performance Counters (Linux perf_event_open)
+ *
+ * Each benchmark thread opens its own set of counters when it enters the
+ * timed region and enables/disables them with one ioctl each, so they
+ * always count the thread that calls perf_thread_start. Events the kernel
+ * or hypervisor refuses are dropped individually; if none can be opened
+ * the session reports itself as unavailable and the benchmark carries on
+ * without counters.
+ */
+
+typedef enum {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_NUM_EVENTS
+} PerfEvent;
+
+typedef struct {
+    uint64_t values[PERF_NUM_EVENTS];  // Summed over threads, scaled for multiplexing
+    bool valid[PERF_NUM_EVENTS];       // False if the event could not be counted
+} PerfTotals;
+
+typedef struct PerfSession PerfSession;
+
+// Prepares counters for an OpenMP team of num_threads and checks which
+// events can be opened. Returns NULL (after a one-line warning) when
+// counters are not permitted.
+PerfSession* perf_session_open(int num_threads);
+
+// Called by each worker thread at the start/end of the timed region
+void perf_thread_start(PerfSession* session);
+void perf_thread_stop(PerfSession* session);
+
+void perf_session_read(PerfSession* session, PerfTotals* totals);
+void perf_session_close(PerfSession* session);
+
+const char* perf_event_name(PerfEvent event);
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,90 @@
+#include "scenario.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+static bool parse_setting(ScenarioPhase* phase, const char* key, const char* value) {
+    char* end;
+    if (strcmp(key, "threads") == 0) {
+        phase->threads = (int)strtol(value, &end, 10);
+    } else if (strcmp(key, "insert") == 0) {
+        phase->insert_percent = (int)strtol(value, &end, 10);
+    } else if (strcmp(key, "delete") == 0) {
+        phase->delete_percent = (int)strtol(value, &end, 10);
+    } else if (strcmp(key, "scan") == 0) {
+        phase->scan_length = (int)strtol(value, &end, 10);
+    } else if (strcmp(key, "ops") == 0) {
+        phase->ops_per_thread = strtol(value, &end, 10);
+    } else if (strcmp(key, "duration") == 0) {
+        phase->duration = strtod(value, &end);
+    } else {
+        return false;
+    }
+    return *value != '\0' && *end == '\0';
+}
+
+static const char* check_phase(ScenarioPhase* phase, int max_threads) {
+    if (phase->threads < 1 || phase->threads > max_threads) return "threads out of range";
+    if (phase->insert_percent < 0 || phase->delete_percent < 0 ||
+        phase->insert_percent + phase->delete_percent > 100) return "insert + delete must be 0..100";
+    if (phase->scan_length < 0) return "scan must not be negative";
+    if ((phase->ops_per_thread > 0) == (phase->duration > 0)) return "give exactly one of ops= and duration=";
+    if (phase->ops_per_thread > INT_MAX) return "ops must not exceed INT_MAX";  // The driver counts in int
+    return NULL;
+}
+
+int scenario_load(const char* path, ScenarioPhase* phases, int max_phases, int max_threads) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror("Failed to open scenario file");
+        return -1;
+    }
+
+    char line[512];
+    int line_no = 0;
+    int count = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char* token = strtok(line, " \t\r\n");
+        if (!token || token[0] == '#') continue;
+
+        if (count == max_phases) {
+            fprintf(stderr, "%s:%d: more than %d phases\n", path, line_no, max_phases);
+            fclose(f);
+            return -1;
+        }
+
+        ScenarioPhase* phase = &phases[count];
+        memset(phase, 0, sizeof(*phase));
+        phase->threads = 1;
+        snprintf(phase->name, sizeof(phase->name), "%s", token);
+
+        while ((token = strtok(NULL, " \t\r\n")) != NULL) {
+            if (token[0] == '#') break;
+            char* eq = strchr(token, '=');
+            if (eq) *eq = '\0';
+            if (!eq || !parse_setting(phase, token, eq + 1)) {
+                fprintf(stderr, "%s:%d: bad setting '%s'\n", path, line_no, token);
+                fclose(f);
+                return -1;
+            }
+        }
+
+        const char* error = check_phase(phase, max_threads);
+        if (error) {
+            fprintf(stderr, "%s:%d: phase '%s': %s\n", path, line_no, phase->name, error);
+            fclose(f);
+            return -1;
+        }
+        count++;
+    }
+
+    fclose(f);
+    if (count == 0) {
+        fprintf(stderr, "%s: no phases\n", path);
+        return -1;
+    }
+    return count;
+}
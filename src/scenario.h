@@ -0,0 +1,40 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <stdbool.h>
+
+/**
+ * Phased Benchmark Scenarios
+ *
+ * A scenario file lists phases that run back to back on one list, one
+ * phase per line: a name followed by key=value settings.
+ *
+ *     # name     settings
+ *     bulk_load  threads=4 insert=100 ops=25000
+ *     steady     threads=8 insert=20 delete=10 duration=10
+ *     drain      threads=8 delete=100 ops=20000
+ *     scan_burst threads=8 scan=64 ops=50000
+ *
+ * Settings: threads, insert and delete percentages (the rest are contains),
+ * ops per thread or duration in seconds (exactly one), and scan=N, which
+ * makes each thread visit runs of N consecutive keys instead of random ones.
+ * Blank lines and lines starting with '#' are ignored.
+ */
+
+#define SCENARIO_MAX_PHASES 64
+
+typedef struct {
+    char name[32];
+    int threads;
+    int insert_percent;
+    int delete_percent;
+    int scan_length;        // 0: independent random keys
+    long ops_per_thread;    // Fixed-size phase, or
+    double duration;        // timed phase (seconds)
+} ScenarioPhase;
+
+// Parses path into phases; returns the phase count, or -1 after printing
+// the offending line to stderr
+int scenario_load(const char* path, ScenarioPhase* phases, int max_phases, int max_threads);
+
+#endif // SCENARIO_H
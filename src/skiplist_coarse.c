@@ -1,4 +1,5 @@
 #include "skiplist_common.h"
+#include "skiplist_instrument.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <limits.h>
@@ -15,23 +16,39 @@
  * Cons: Zero concurrency. Readers block writers, writers block readers.
  */
 
-SkipList* skiplist_create_coarse(void) {
+// Indexable lists allocate each node with one width per level right after
+// it: width[l] is the number of level-0 links that next[l] spans, so summing
+// widths along a descent gives a node's position (head = 0). The tail has none.
+#define WIDTHS(node) ((int*)((node) + 1))
+
+static Node* create_coarse_node(SkipList* list, int key, int value, int level) {
+    if (!list->indexable) return create_node(key, value, level);
+    return create_node_extra(key, value, level, (level + 1) * sizeof(int));
+}
+
+static SkipList* create_coarse(bool indexable) {
     SkipList* list = (SkipList*)malloc(sizeof(SkipList));
     if (!list) {
         perror("Failed to allocate skip list");
         exit(1);
     }
+    list->indexable = indexable;
     
     // Create sentinels
-    list->head = create_node(INT_MIN, 0, MAX_LEVEL);
+    list->head = create_coarse_node(list, INT_MIN, 0, MAX_LEVEL);
     list->tail = create_node(INT_MAX, 0, MAX_LEVEL);
+    if (indexable) {
+        for (int i = 0; i <= MAX_LEVEL; i++) {
+            WIDTHS(list->head)[i] = 1;
+        }
+    }
     
     // Using static max level for simplicity
     list->maxLevel = MAX_LEVEL;
     atomic_init(&list->size, 0);
     
     // Initialize the Global Lock
-    omp_init_lock(&list->lock);
+    skiplock_init(&list->lock);
     
     // Link head to tail
     for (int i = 0; i <= MAX_LEVEL; i++) {
@@ -46,27 +63,39 @@ SkipList* skiplist_create_coarse(void) {
     return list;
 }
 
-bool skiplist_insert_coarse(SkipList* list, int key, int value) {
+SkipList* skiplist_create_coarse(void) {
+    return create_coarse(false);
+}
+
+SkipList* skiplist_create_coarse_indexable(void) {
+    return create_coarse(true);
+}
+
+static bool insert_coarse(SkipList* list, int key, int value) {
     // 1. Acquire Global Lock
-    omp_set_lock(&list->lock);
+    lock_acquire(&list->lock);
     
     Node* preds[MAX_LEVEL + 1];
+    int pos[MAX_LEVEL + 1];  // Position of preds[level] (indexable lists)
     Node* pred = list->head;
+    int rank = 0;
     
     // 2. Search for position
     for (int level = list->maxLevel; level >= 0; level--) {
         Node* curr = atomic_load(&pred->next[level]);
         
         while (curr != list->tail && curr->key < key) {
+            if (list->indexable) rank += WIDTHS(pred)[level];
             pred = curr;
             curr = atomic_load(&pred->next[level]);
         }
         
         preds[level] = pred;
+        pos[level] = rank;
         
         // Check for duplicates
         if (level == 0 && curr != list->tail && curr->key == key) {
-            omp_unset_lock(&list->lock);
+            lock_release(&list->lock);
             return false;
         }
     }
@@ -75,7 +104,7 @@ bool skiplist_insert_coarse(SkipList* list, int key, int value) {
     // Note: Allocating inside the lock increases critical section time,
     // but ensures we don't allocate if the key already exists.
     int topLevel = random_level();
-    Node* newNode = create_node(key, value, topLevel);
+    Node* newNode = create_coarse_node(list, key, value, topLevel);
     atomic_store(&newNode->fully_linked, true);
     
     // 4. Link Node
@@ -85,15 +114,28 @@ bool skiplist_insert_coarse(SkipList* list, int key, int value) {
         atomic_store(&preds[level]->next[level], newNode);
     }
     
+    // The new node sits at position pos[0] + 1; split the links it cuts
+    // and widen the ones above its tower
+    if (list->indexable) {
+        for (int level = 0; level <= topLevel; level++) {
+            WIDTHS(newNode)[level] = WIDTHS(preds[level])[level] - (pos[0] - pos[level]);
+            WIDTHS(preds[level])[level] = pos[0] + 1 - pos[level];
+        }
+        for (int level = topLevel + 1; level <= list->maxLevel; level++) {
+            WIDTHS(preds[level])[level]++;
+        }
+    }
+    
     atomic_fetch_add(&list->size, 1);
+    TRACE_PROBE2(insert, key, topLevel);
     
     // 5. Release Lock
-    omp_unset_lock(&list->lock);
+    lock_release(&list->lock);
     return true;
 }
 
-bool skiplist_delete_coarse(SkipList* list, int key) {
-    omp_set_lock(&list->lock);
+static bool delete_coarse(SkipList* list, int key) {
+    lock_acquire(&list->lock);
     
     Node* preds[MAX_LEVEL + 1];
     Node* pred = list->head;
@@ -114,7 +156,7 @@ bool skiplist_delete_coarse(SkipList* list, int key) {
             if (curr != list->tail && curr->key == key) {
                 victim = curr;
             } else {
-                omp_unset_lock(&list->lock);
+                lock_release(&list->lock);
                 return false; // Not found
             }
         }
@@ -126,21 +168,32 @@ bool skiplist_delete_coarse(SkipList* list, int key) {
         atomic_store(&preds[level]->next[level], succ);
     }
     
+    // Merge the victim's links into its predecessors' and shorten the
+    // links above its tower
+    if (list->indexable) {
+        for (int level = 0; level <= victim->topLevel; level++) {
+            WIDTHS(preds[level])[level] += WIDTHS(victim)[level] - 1;
+        }
+        for (int level = victim->topLevel + 1; level <= list->maxLevel; level++) {
+            WIDTHS(preds[level])[level]--;
+        }
+    }
+    
     atomic_fetch_sub(&list->size, 1);
-    omp_unset_lock(&list->lock);
+    TRACE_PROBE1(delete, key);
+    lock_release(&list->lock);
     
     // Safe to free outside lock because node is now unreachable
     // and we are not using lock-free optimistic readers.
-    omp_destroy_lock(&victim->lock); // Clean up the unused node lock
-    free(victim);
+    free_node(victim);
     
     return true;
 }
 
-bool skiplist_contains_coarse(SkipList* list, int key) {
+static bool contains_coarse(SkipList* list, int key) {
     // Crucial: Readers must acquire lock in Coarse-Grained
     // Otherwise a writer could free a node while we are traversing it.
-    omp_set_lock(&list->lock);
+    lock_acquire(&list->lock);
     
     Node* pred = list->head;
     
@@ -157,21 +210,182 @@ bool skiplist_contains_coarse(SkipList* list, int key) {
     Node* curr = atomic_load(&pred->next[0]);
     bool found = (curr != list->tail && curr->key == key);
     
-    omp_unset_lock(&list->lock);
+    lock_release(&list->lock);
     return found;
 }
 
-void skiplist_destroy_coarse(SkipList* list) {
-    // No lock needed if we assume only one thread calls destroy
-    Node* curr = list->head;
+// Number of keys smaller than `key`
+static int rank_coarse(SkipList* list, int key) {
+    int rank = 0;
     
-    while (curr != NULL) {
-        Node* next = atomic_load(&curr->next[0]);
-        omp_destroy_lock(&curr->lock); // Clean up unused node locks
-        free(curr);
-        curr = next;
+    if (list->indexable) {
+        Node* pred = list->head;
+        for (int level = list->maxLevel; level >= 0; level--) {
+            Node* curr = atomic_load(&pred->next[level]);
+            while (curr != list->tail && curr->key < key) {
+                rank += WIDTHS(pred)[level];
+                pred = curr;
+                curr = atomic_load(&pred->next[level]);
+            }
+        }
+        return rank;
     }
     
-    omp_destroy_lock(&list->lock);
+    for (Node* curr = atomic_load(&list->head->next[0]); curr != list->tail && curr->key < key;
+         curr = atomic_load(&curr->next[0])) {
+        rank++;
+    }
+    return rank;
+}
+
+// The node at position k + 1 (the k-th smallest key, counting from 0)
+static bool select_coarse(SkipList* list, int k, int* key) {
+    if (k < 0 || k >= atomic_load(&list->size)) return false;
+    
+    Node* pred = list->head;
+    if (list->indexable) {
+        int pos = 0;
+        for (int level = list->maxLevel; level >= 0; level--) {
+            Node* curr = atomic_load(&pred->next[level]);
+            while (curr != list->tail && pos + WIDTHS(pred)[level] <= k + 1) {
+                pos += WIDTHS(pred)[level];
+                pred = curr;
+                curr = atomic_load(&pred->next[level]);
+            }
+        }
+    } else {
+        for (int i = 0; i <= k; i++) {
+            pred = atomic_load(&pred->next[0]);
+        }
+    }
+    *key = pred->key;
+    return true;
+}
+
+// Last node before `key` on every level, with its position
+static void find_preds_coarse(SkipList* list, int key, Node** preds, int* pos) {
+    Node* pred = list->head;
+    int rank = 0;
+    
+    for (int level = list->maxLevel; level >= 0; level--) {
+        Node* curr = atomic_load(&pred->next[level]);
+        while (curr != list->tail && curr->key < key) {
+            if (list->indexable) rank += WIDTHS(pred)[level];
+            pred = curr;
+            curr = atomic_load(&pred->next[level]);
+        }
+        preds[level] = pred;
+        pos[level] = rank;
+    }
+}
+
+// Public entry points: bracket each operation for the instrumentation hooks
+bool skiplist_insert_coarse(SkipList* list, int key, int value) {
+    OP_BEGIN(TRACE_EV_INSERT, key);
+    bool inserted = insert_coarse(list, key, value);
+    OP_END(TRACE_EV_INSERT, key, inserted);
+    return inserted;
+}
+
+bool skiplist_delete_coarse(SkipList* list, int key) {
+    OP_BEGIN(TRACE_EV_DELETE, key);
+    bool deleted = delete_coarse(list, key);
+    OP_END(TRACE_EV_DELETE, key, deleted);
+    return deleted;
+}
+
+bool skiplist_contains_coarse(SkipList* list, int key) {
+    OP_BEGIN(TRACE_EV_CONTAINS, key);
+    bool found = contains_coarse(list, key);
+    OP_END(TRACE_EV_CONTAINS, key, found);
+    return found;
+}
+
+int skiplist_rank_coarse(SkipList* list, int key) {
+    lock_acquire(&list->lock);
+    int rank = rank_coarse(list, key);
+    lock_release(&list->lock);
+    return rank;
+}
+
+bool skiplist_select_coarse(SkipList* list, int k, int* key) {
+    lock_acquire(&list->lock);
+    bool found = select_coarse(list, k, key);
+    lock_release(&list->lock);
+    return found;
+}
+
+// Moves the keys >= key into a new list of the same kind. One descent, then
+// one link per level; the moved keys are counted by widths when indexable,
+// otherwise by walking the smaller side.
+SkipList* skiplist_split_coarse(SkipList* list, int key) {
+    SkipList* into = create_coarse(list->indexable);
+    Node* preds[MAX_LEVEL + 1];
+    int pos[MAX_LEVEL + 1];
+    
+    lock_acquire(&list->lock);
+    find_preds_coarse(list, key, preds, pos);
+    
+    int moved = -1;
+    if (list->indexable) {
+        // pos[0] keys stay; each cut link now ends at a tail one past them
+        int kept = pos[0];
+        moved = atomic_load(&list->size) - kept;
+        for (int level = 0; level <= list->maxLevel; level++) {
+            WIDTHS(into->head)[level] = WIDTHS(preds[level])[level] + pos[level] - kept;
+            WIDTHS(preds[level])[level] = kept + 1 - pos[level];
+        }
+    }
+    split_at_preds(list, into, preds, moved);
+    lock_release(&list->lock);
+    return into;
+}
+
+// Appends `other` to `list` and frees `other` if every key of `list` is
+// smaller than every key of `other`; otherwise both are left unchanged.
+// Both must be plain or both indexable, and `other` must be quiescent.
+bool skiplist_join_coarse(SkipList* list, SkipList* other) {
+    if (list == other || list->indexable != other->indexable) return false;
+    
+    // Lock in address order so concurrent joins cannot deadlock. Only
+    // `list` goes through the profiled hooks: the lock profile keeps one
+    // hold timestamp per thread, and `other` is consumed, not held.
+    if (list < other) {
+        lock_acquire(&list->lock);
+        skiplock_lock(&other->lock);
+    } else {
+        skiplock_lock(&other->lock);
+        lock_acquire(&list->lock);
+    }
+    
+    Node* lasts[MAX_LEVEL + 1];
+    int pos[MAX_LEVEL + 1];
+    find_preds_coarse(list, INT_MAX, lasts, pos);
+    
+    int widths[MAX_LEVEL + 1];
+    if (list->indexable) {
+        // Each last link skips the dropped tail and continues into other
+        for (int level = 0; level <= list->maxLevel; level++) {
+            widths[level] = WIDTHS(lasts[level])[level] - 1 + WIDTHS(other->head)[level];
+        }
+    }
+    
+    // On success join_at_lasts frees `other` along with its lock
+    bool joined = join_at_lasts(list, other, lasts);
+    if (!joined) {
+        skiplock_unlock(&other->lock);
+    } else if (list->indexable) {
+        for (int level = 0; level <= list->maxLevel; level++) {
+            WIDTHS(lasts[level])[level] = widths[level];
+        }
+    }
+    lock_release(&list->lock);
+    return joined;
+}
+
+void skiplist_destroy_coarse(SkipList* list) {
+    // No lock needed if we assume only one thread calls destroy
+    free_all_nodes(list);
+    skiplock_destroy(&list->lock);
     free(list);
 }
\ No newline at end of file
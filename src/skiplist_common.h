@@ -4,7 +4,9 @@
 #include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <omp.h>
+#include "skiplist_lock.h"
 
 // Configuration
 #define MAX_LEVEL 16
@@ -28,7 +30,7 @@ typedef struct Node {
     _Atomic(bool) marked;  // For logical deletion in fine-grained
     _Atomic(bool) fully_linked;  // True when all levels are linked
     _Atomic(struct Node*) next[MAX_LEVEL + 1];
-    omp_lock_t lock;  // For fine-grained locking version
+    SkipLock lock;  // For fine-grained locking version
 } Node;
 
 // Skip list structure
@@ -37,7 +39,8 @@ typedef struct SkipList {
     Node* tail;
     int maxLevel;
     _Atomic(int) size;
-    omp_lock_t lock;  // For coarse-grained locking
+    SkipLock lock;  // For coarse-grained locking
+    bool indexable; // Coarse only: nodes carry per-link widths (rank/select)
 } SkipList;
 
 // Function prototypes for all implementations
@@ -47,6 +50,16 @@ bool skiplist_insert_coarse(SkipList* list, int key, int value);
 bool skiplist_delete_coarse(SkipList* list, int key);
 bool skiplist_contains_coarse(SkipList* list, int key);
 void skiplist_destroy_coarse(SkipList* list);
+// Order statistics. Exact and O(log n) on a list from
+// skiplist_create_coarse_indexable(); on a plain coarse list they walk level 0.
+SkipList* skiplist_create_coarse_indexable(void);
+int skiplist_rank_coarse(SkipList* list, int key);                // Keys < key
+bool skiplist_select_coarse(SkipList* list, int k, int* key);     // k-th smallest, from 0
+// Split moves the keys >= key into a new list; join appends `other` (all
+// keys larger) and frees it, or returns false. O(MAX_LEVEL) link updates.
+// No other thread may use `other` during or after a join.
+SkipList* skiplist_split_coarse(SkipList* list, int key);
+bool skiplist_join_coarse(SkipList* list, SkipList* other);
 
 // Fine-grained
 SkipList* skiplist_create_fine(void);
@@ -54,6 +67,12 @@ bool skiplist_insert_fine(SkipList* list, int key, int value);
 bool skiplist_delete_fine(SkipList* list, int key);
 bool skiplist_contains_fine(SkipList* list, int key);
 void skiplist_destroy_fine(SkipList* list);
+// Keys in [from, to): delete returns how many it removed
+int skiplist_delete_range_fine(SkipList* list, int from, int to);
+int skiplist_count_range_fine(SkipList* list, int from, int to);
+// As the coarse split/join, but both lists must be quiescent
+SkipList* skiplist_split_fine(SkipList* list, int key);
+bool skiplist_join_fine(SkipList* list, SkipList* other);
 
 // Lock-free
 SkipList* skiplist_create_lockfree(void);
@@ -61,11 +80,146 @@ bool skiplist_insert_lockfree(SkipList* list, int key, int value);
 bool skiplist_delete_lockfree(SkipList* list, int key);
 bool skiplist_contains_lockfree(SkipList* list, int key);
 void skiplist_destroy_lockfree(SkipList* list);
+int skiplist_delete_range_lockfree(SkipList* list, int from, int to);
+int skiplist_count_range_lockfree(SkipList* list, int from, int to);
+SkipList* skiplist_split_lockfree(SkipList* list, int key);  // Quiescent lists only
+bool skiplist_join_lockfree(SkipList* list, SkipList* other);
+// Removes the smallest key; false if the list is empty
+bool skiplist_pop_min_lockfree(SkipList* list, int* key, int* value);
+// Removes one of roughly the first threads * log2(threads)^3 keys (SprayList);
+// `threads` is the number of threads popping concurrently
+bool skiplist_pop_approx_min_lockfree(SkipList* list, int threads, int* key, int* value);
+// Bare primitives without the op hooks, for bin/microbench
+bool skiplist_find_lockfree(SkipList* list, int key);
+void skiplist_backoff_lockfree(int* attempt);
+
+// ------------------------------------------------------------------------
+// Instrumentation (each feature has its own -D flag, see the Makefile)
+// Counters are kept per thread in cache-line-padded slots and summed on
+// demand; the getters return false when instrumentation is compiled out.
+// ------------------------------------------------------------------------
+#define MAX_INSTRUMENT_THREADS 256
+
+// Lock-free contention counters
+typedef struct {
+    uint64_t cas_failures[MAX_LEVEL + 1];  // Failed link/mark/helping CAS, per level
+    uint64_t find_restarts;                // find() restarted from head
+    uint64_t helping_unlinks;              // Marked nodes physically unlinked by find()
+    uint64_t backoff_calls;
+    uint64_t backoff_yields;               // backoff() calls that ended in sched_yield()
+    uint64_t tower_abandons;               // Tower build stopped: node deleted meanwhile
+    uint64_t tower_levels_skipped;         // Tower cut short: a level failed 3 link attempts
+    uint64_t retries_exhausted;            // insert/delete gave up after MAX_RETRIES
+    uint64_t pop_prefix_skips;             // Deleted nodes walked past by pop_min
+    uint64_t pop_cleanups;                 // Deleted prefixes unlinked by one head CAS
+} ContentionStats;
+
+bool skiplist_contention_stats(ContentionStats* out);
+void skiplist_contention_reset(void);
+
+// Lock timing for the coarse and fine variants (-DSKIPLIST_LOCK_PROFILE)
+typedef struct {
+    uint64_t acquisitions;
+    uint64_t wait_ns;              // Time spent blocked in lock acquisition
+    uint64_t max_wait_ns;
+    uint64_t hold_ns;              // Time between acquisition and release
+    uint64_t validation_failures;  // Fine: post-lock validation failed
+    uint64_t head_rescans;         // Fine: one level's predecessor re-searched from head
+    uint64_t parks;                // Acquisitions that slept on the futex
+} LockProfile;
+
+bool skiplist_lock_profile(LockProfile* out);
+void skiplist_lock_profile_reset(void);
+
+// Per-thread event rings exported as Chrome/Perfetto trace JSON
+// (-DSKIPLIST_TRACE). Both calls require that no operations are running.
+bool skiplist_trace_dump(const char* path);
+void skiplist_trace_reset(void);
+
+// Node allocation accounting (always on, process-wide). Deleted nodes in
+// the fine and lock-free variants are never freed, so allocated - freed
+// exceeds the live size by the retired (leaked) nodes.
+typedef struct {
+    uint64_t nodes_allocated;
+    uint64_t nodes_freed;
+} MemoryStats;
+
+void skiplist_memory_stats(MemoryStats* out);
+
+// Prometheus text-format snapshot of op counts and latency histograms
+// (-DSKIPLIST_METRICS), retries (-DSKIPLIST_STATS), lock timing
+// (-DSKIPLIST_LOCK_PROFILE), size and node memory (always). Safe to call
+// while operations are running; `impl` becomes the impl label.
+typedef void (*MetricsSink)(const char* text, size_t len, void* ctx);
+
+bool skiplist_metrics_snapshot(SkipList* list, const char* impl, MetricsSink sink, void* ctx);
+bool skiplist_metrics_write_file(SkipList* list, const char* impl, const char* path);
+void skiplist_metrics_reset(void);
+
+// Structural statistics (see skiplist_stats)
+typedef struct {
+    int nodes_per_level[MAX_LEVEL + 1];   // Nodes reachable at each level
+    int keys;                             // Live (unmarked) keys at level 0
+    int marked_linked;                    // Logically deleted but still linked at level 0
+    int path_samples;                     // Searches simulated for the path figures
+    double avg_path_length;               // Nodes visited per search, all levels
+    int max_path_length;
+    double avg_hops_per_level[MAX_LEVEL + 1];
+    size_t node_bytes;                    // sizeof(Node) * reachable nodes
+    double bytes_per_key;
+} SkipListStats;
+
+// Result of validate_skiplist_parallel
+typedef struct {
+    int nodes_per_level[MAX_LEVEL + 1];   // Nodes linked at each level
+    int keys;                             // Live (unmarked) keys at level 0
+    int marked_linked;                    // Logically deleted but still linked at level 0
+    int size;                             // list->size at validation time
+    int order_errors;     // Keys out of order, or duplicate live keys, within a level
+    int tower_errors;     // Live node at level i that is missing from level i - 1
+    int height_errors;    // Node linked above its topLevel
+    int split_level;      // Level whose nodes bound the partitions (0: serial)
+    int partitions;
+    int threads;
+    double seconds;
+} ValidationReport;
+
+// Snapshot for skiplist_rank_estimate / skiplist_select_estimate
+typedef struct {
+    int level;        // Every live node this tall was sampled
+    int count;
+    Node** nodes;     // Sampled nodes in key order
+    int* ranks;       // Their rank (keys before them) when sampled
+    int size;         // Live keys when sampled; select stops there
+} RankSample;
 
 // Utility functions
 int random_level(void);
 Node* create_node(int key, int value, int level);
+Node* create_node_extra(int key, int value, int level, size_t extra_bytes);
+void free_node(Node* node);
+void free_all_nodes(SkipList* list);
+// Split/join plumbing for the variants. split_at_preds moves everything
+// after preds[] (the last nodes before the cut, per level) into the empty
+// list `into`; moved < 0 counts the moved keys. join_at_lasts appends
+// `other` after lasts[] (the last nodes of `list`) and frees it, or returns
+// false if the keys overlap. Both lists must be quiescent.
+void split_at_preds(SkipList* list, SkipList* into, Node** preds, int moved);
+bool join_at_lasts(SkipList* list, SkipList* other, Node** lasts);
 void print_skiplist(SkipList* list);
 bool validate_skiplist(SkipList* list);
+bool validate_skiplist_parallel(SkipList* list, int threads, ValidationReport* report);
+void print_validation_report(ValidationReport* report);
+void skiplist_stats(SkipList* list, SkipListStats* stats);
+void print_skiplist_stats(SkipListStats* stats);
+double skiplist_sample_hops(SkipList* list, int samples, int key_range, unsigned int seed);
+// Approximate order statistics for the fine and lock-free variants, safe
+// while they run. A sample records the ranks of the nodes on one level;
+// queries descend from the nearest sampled node. Retake the sample as the
+// list drifts.
+bool skiplist_rank_sample(SkipList* list, RankSample* sample, int max_samples);
+void free_rank_sample(RankSample* sample);
+int skiplist_rank_estimate(SkipList* list, RankSample* sample, int key);
+bool skiplist_select_estimate(SkipList* list, RankSample* sample, int k, int* key);
 
 #endif // SKIPLIST_COMMON_H
\ No newline at end of file
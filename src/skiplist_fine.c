@@ -1,4 +1,5 @@
 #include "skiplist_common.h"
+#include "skiplist_instrument.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <limits.h>
@@ -12,15 +13,13 @@ SkipList* skiplist_create_fine(void) {
     list->head = create_node(INT_MIN, 0, MAX_LEVEL);
     list->tail = create_node(INT_MAX, 0, MAX_LEVEL);
     
-    omp_init_lock(&list->head->lock);
-    omp_init_lock(&list->tail->lock);
-
     atomic_store(&list->head->fully_linked, true);
     atomic_store(&list->tail->fully_linked, true);
     atomic_init(&list->head->marked, false);
     atomic_init(&list->tail->marked, false);
 
     list->maxLevel = MAX_LEVEL;
+    list->indexable = false;
     atomic_init(&list->size, 0);
     
     for (int i = 0; i <= MAX_LEVEL; i++) {
@@ -50,7 +49,7 @@ static bool validate_link(Node* pred, Node* succ, int level) {
            (atomic_load(&pred->next[level]) == succ);
 }
 
-bool skiplist_insert_fine(SkipList* list, int key, int value) {
+static bool insert_fine(SkipList* list, int key, int value) {
     Node* preds[MAX_LEVEL + 1];
     Node* succs[MAX_LEVEL + 1];
     
@@ -62,17 +61,18 @@ bool skiplist_insert_fine(SkipList* list, int key, int value) {
             if (!atomic_load(&found->marked)) return false; 
         }
         
-        omp_set_lock(&preds[0]->lock);
+        lock_acquire(&preds[0]->lock);
         
         if (!validate_link(preds[0], succs[0], 0)) {
-            omp_unset_lock(&preds[0]->lock);
+            lock_release(&preds[0]->lock);
+            NOTE_VALIDATION_FAILURE(0, key);
             continue; 
         }
         
         found = succs[0];
         if (found != list->tail && found->key == key) {
             if (!atomic_load(&found->marked)) {
-                omp_unset_lock(&preds[0]->lock);
+                lock_release(&preds[0]->lock);
                 return false;
             }
         }
@@ -85,14 +85,17 @@ bool skiplist_insert_fine(SkipList* list, int key, int value) {
         }
         
         atomic_store(&preds[0]->next[0], newNode);
-        omp_unset_lock(&preds[0]->lock);
+        TRACE_PROBE2(insert, key, topLevel);
+        lock_release(&preds[0]->lock);
         atomic_fetch_add(&list->size, 1);
         
         for (int i = 1; i <= topLevel; i++) {
             while (true) {
-                omp_set_lock(&preds[i]->lock);
+                lock_acquire(&preds[i]->lock);
                 if (!validate_link(preds[i], succs[i], i)) {
-                    omp_unset_lock(&preds[i]->lock);
+                    lock_release(&preds[i]->lock);
+                    NOTE_VALIDATION_FAILURE(i, key);
+                    NOTE_HEAD_RESCAN();
                     Node* p = list->head;
                     Node* c = atomic_load(&p->next[i]);
                     while (c != list->tail && c->key < key) {
@@ -105,7 +108,7 @@ bool skiplist_insert_fine(SkipList* list, int key, int value) {
                 }
                 atomic_store(&newNode->next[i], succs[i]);
                 atomic_store(&preds[i]->next[i], newNode);
-                omp_unset_lock(&preds[i]->lock);
+                lock_release(&preds[i]->lock);
                 break;
             }
         }
@@ -114,7 +117,7 @@ bool skiplist_insert_fine(SkipList* list, int key, int value) {
     }
 }
 
-bool skiplist_delete_fine(SkipList* list, int key) {
+static bool delete_fine(SkipList* list, int key) {
     Node* preds[MAX_LEVEL + 1];
     Node* succs[MAX_LEVEL + 1];
     while (true) {
@@ -123,29 +126,32 @@ bool skiplist_delete_fine(SkipList* list, int key) {
         
         if (victim == list->tail || victim->key != key) return false;
         
-        omp_set_lock(&victim->lock);
+        lock_acquire(&victim->lock);
         
         if (atomic_load(&victim->marked)) {
-            omp_unset_lock(&victim->lock);
+            lock_release(&victim->lock);
             return false;
         }
         if (victim->key != key) {
-            omp_unset_lock(&victim->lock);
+            lock_release(&victim->lock);
             continue; 
         }
         if (!atomic_load(&victim->fully_linked)) {
-            omp_unset_lock(&victim->lock);
+            lock_release(&victim->lock);
             return false; 
         }
         
         atomic_store(&victim->marked, true);
-        omp_unset_lock(&victim->lock);
+        TRACE_PROBE1(delete, key);
+        lock_release(&victim->lock);
         
         for (int i = victim->topLevel; i >= 0; i--) {
             while (true) {
-                omp_set_lock(&preds[i]->lock);
+                lock_acquire(&preds[i]->lock);
                 if (atomic_load(&preds[i]->marked) || atomic_load(&preds[i]->next[i]) != victim) {
-                    omp_unset_lock(&preds[i]->lock);
+                    lock_release(&preds[i]->lock);
+                    NOTE_VALIDATION_FAILURE(i, key);
+                    NOTE_HEAD_RESCAN();
                     Node* p = list->head;
                     Node* c = atomic_load(&p->next[i]);
                     while (c != list->tail && c->key < key) {
@@ -157,7 +163,7 @@ bool skiplist_delete_fine(SkipList* list, int key) {
                 }
                 Node* next = atomic_load(&victim->next[i]);
                 atomic_store(&preds[i]->next[i], next);
-                omp_unset_lock(&preds[i]->lock);
+                lock_release(&preds[i]->lock);
                 break;
             }
         }
@@ -166,7 +172,103 @@ bool skiplist_delete_fine(SkipList* list, int key) {
     }
 }
 
-bool skiplist_contains_fine(SkipList* list, int key) {
+// Unlinks victims[0..count) (marked, in key order) at `level`. Consecutive
+// victims are unlinked with a single store under their predecessor's lock;
+// a stale predecessor is looked up again from head, as in delete_fine.
+static void unlink_run_fine(SkipList* list, Node** victims, int count, int level, Node* pred) {
+    int i = 0;
+    while (i < count && victims[i]->topLevel < level) i++;
+    
+    while (i < count) {
+        Node* victim = victims[i];
+        lock_acquire(&pred->lock);
+        if (atomic_load(&pred->marked) || atomic_load(&pred->next[level]) != victim) {
+            lock_release(&pred->lock);
+            NOTE_VALIDATION_FAILURE(level, victim->key);
+            NOTE_HEAD_RESCAN();
+            Node* p = list->head;
+            Node* c = atomic_load(&p->next[level]);
+            while (c != list->tail && c->key < victim->key) {
+                p = c;
+                c = atomic_load(&p->next[level]);
+            }
+            pred = p;
+            continue;
+        }
+        
+        // Extend over the following victims while they are linked right
+        // after this one; victims' next pointers no longer change
+        Node* next = atomic_load(&victim->next[level]);
+        for (i++; i < count; i++) {
+            if (victims[i]->topLevel < level) continue;
+            if (victims[i] != next) break;
+            next = atomic_load(&next->next[level]);
+        }
+        atomic_store(&pred->next[level], next);
+        lock_release(&pred->lock);
+    }
+}
+
+// Deletes every key in [from, to) and returns how many this call removed.
+// One descent locates the run. Each node is then marked under its own lock,
+// walking level 0, and the marked nodes are unlinked level by level, a
+// whole run per predecessor lock. Keys inserted into the range while this
+// runs may survive it.
+static int delete_range_fine(SkipList* list, int from, int to) {
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    
+    if (from >= to) return 0;
+    find_optimistic(list, from, preds, succs);
+    
+    int count = 0, capacity = 0;
+    Node** victims = NULL;
+    for (Node* curr = atomic_load(&preds[0]->next[0]); curr != list->tail && curr->key < to;
+         curr = atomic_load(&curr->next[0])) {
+        lock_acquire(&curr->lock);
+        bool claimed = !atomic_load(&curr->marked) && atomic_load(&curr->fully_linked);
+        if (claimed) {
+            if (count == capacity) {
+                capacity = capacity ? 2 * capacity : 64;
+                Node** grown = realloc(victims, capacity * sizeof(Node*));
+                if (!grown) {
+                    perror("Failed to allocate range victims");
+                    exit(1);
+                }
+                victims = grown;
+            }
+            atomic_store(&curr->marked, true);
+            TRACE_PROBE1(delete, curr->key);
+            victims[count++] = curr;
+        }
+        lock_release(&curr->lock);
+    }
+    
+    for (int level = list->maxLevel; level >= 0; level--) {
+        unlink_run_fine(list, victims, count, level, preds[level]);
+    }
+    free(victims);
+    
+    atomic_fetch_sub(&list->size, count);
+    return count;
+}
+
+// Live keys in [from, to): one descent, then a walk on level 0. Not a
+// snapshot under concurrent updates.
+static int count_range_fine(SkipList* list, int from, int to) {
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    int count = 0;
+    
+    find_optimistic(list, from, preds, succs);
+    for (Node* curr = atomic_load(&preds[0]->next[0]); curr != list->tail && curr->key < to;
+         curr = atomic_load(&curr->next[0])) {
+        if (atomic_load(&curr->fully_linked) && !atomic_load(&curr->marked)) count++;
+    }
+    return count;
+}
+
+static bool contains_fine(SkipList* list, int key) {
     Node* pred = list->head;
     Node* curr = NULL;
     for (int level = list->maxLevel; level >= 0; level--) {
@@ -179,13 +281,63 @@ bool skiplist_contains_fine(SkipList* list, int key) {
     return (curr != list->tail && curr->key == key && atomic_load(&curr->fully_linked) && !atomic_load(&curr->marked));
 }
 
+// Public entry points: bracket each operation for the instrumentation hooks
+bool skiplist_insert_fine(SkipList* list, int key, int value) {
+    OP_BEGIN(TRACE_EV_INSERT, key);
+    bool inserted = insert_fine(list, key, value);
+    OP_END(TRACE_EV_INSERT, key, inserted);
+    return inserted;
+}
+
+bool skiplist_delete_fine(SkipList* list, int key) {
+    OP_BEGIN(TRACE_EV_DELETE, key);
+    bool deleted = delete_fine(list, key);
+    OP_END(TRACE_EV_DELETE, key, deleted);
+    return deleted;
+}
+
+bool skiplist_contains_fine(SkipList* list, int key) {
+    OP_BEGIN(TRACE_EV_CONTAINS, key);
+    bool found = contains_fine(list, key);
+    OP_END(TRACE_EV_CONTAINS, key, found);
+    return found;
+}
+
+int skiplist_delete_range_fine(SkipList* list, int from, int to) {
+    OP_BEGIN(TRACE_EV_DELETE, from);
+    int deleted = delete_range_fine(list, from, to);
+    OP_END(TRACE_EV_DELETE, from, deleted > 0);
+    return deleted;
+}
+
+int skiplist_count_range_fine(SkipList* list, int from, int to) {
+    OP_BEGIN(TRACE_EV_CONTAINS, from);
+    int count = count_range_fine(list, from, to);
+    OP_END(TRACE_EV_CONTAINS, from, count > 0);
+    return count;
+}
+
+// Quiesced: no other thread may touch either list during the call
+SkipList* skiplist_split_fine(SkipList* list, int key) {
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    SkipList* into = skiplist_create_fine();
+    
+    find_optimistic(list, key, preds, succs);
+    split_at_preds(list, into, preds, -1);
+    return into;
+}
+
+bool skiplist_join_fine(SkipList* list, SkipList* other) {
+    Node* lasts[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    
+    if (list == other) return false;
+    find_optimistic(list, INT_MAX, lasts, succs);
+    return join_at_lasts(list, other, lasts);
+}
+
 void skiplist_destroy_fine(SkipList* list) {
-    Node* curr = list->head;
-    while (curr) {
-        Node* next = atomic_load(&curr->next[0]);
-        omp_destroy_lock(&curr->lock);
-        free(curr);
-        curr = next;
-    }
+    free_all_nodes(list);
     free(list);
 }
\ No newline at end of file
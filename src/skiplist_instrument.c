@@ -0,0 +1,278 @@
+#include "skiplist_instrument.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+__thread int instrument_slot = -1;
+static _Atomic(int) next_slot = 0;
+
+int instrument_register_thread(void) {
+    int slot = atomic_fetch_add(&next_slot, 1) % MAX_INSTRUMENT_THREADS;
+    instrument_slot = slot;
+    return slot;
+}
+
+// ------------------------------------------------------------------------
+// Node allocation accounting
+// ------------------------------------------------------------------------
+PaddedMemoryStats memory_slots[MAX_INSTRUMENT_THREADS];
+
+void skiplist_memory_stats(MemoryStats* out) {
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < MAX_INSTRUMENT_THREADS; t++) {
+        out->nodes_allocated += memory_slots[t].stats.nodes_allocated;
+        out->nodes_freed += memory_slots[t].stats.nodes_freed;
+    }
+}
+
+// ------------------------------------------------------------------------
+// Lock-free contention counters
+// ------------------------------------------------------------------------
+#ifdef SKIPLIST_STATS
+
+PaddedContentionStats contention_slots[MAX_INSTRUMENT_THREADS];
+
+bool skiplist_contention_stats(ContentionStats* out) {
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < MAX_INSTRUMENT_THREADS; t++) {
+        ContentionStats* s = &contention_slots[t].stats;
+        for (int level = 0; level <= MAX_LEVEL; level++) {
+            out->cas_failures[level] += s->cas_failures[level];
+        }
+        out->find_restarts += s->find_restarts;
+        out->helping_unlinks += s->helping_unlinks;
+        out->backoff_calls += s->backoff_calls;
+        out->backoff_yields += s->backoff_yields;
+        out->tower_abandons += s->tower_abandons;
+        out->tower_levels_skipped += s->tower_levels_skipped;
+        out->retries_exhausted += s->retries_exhausted;
+        out->pop_prefix_skips += s->pop_prefix_skips;
+        out->pop_cleanups += s->pop_cleanups;
+    }
+    return true;
+}
+
+void skiplist_contention_reset(void) {
+    memset(contention_slots, 0, sizeof(contention_slots));
+}
+
+#else
+
+bool skiplist_contention_stats(ContentionStats* out) {
+    memset(out, 0, sizeof(*out));
+    return false;
+}
+
+void skiplist_contention_reset(void) {
+}
+
+#endif // SKIPLIST_STATS
+
+// ------------------------------------------------------------------------
+// Lock wait / hold profiling
+// ------------------------------------------------------------------------
+#ifdef SKIPLIST_LOCK_PROFILE
+
+PaddedLockProfile lock_profile_slots[MAX_INSTRUMENT_THREADS];
+
+bool skiplist_lock_profile(LockProfile* out) {
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < MAX_INSTRUMENT_THREADS; t++) {
+        LockProfile* p = &lock_profile_slots[t].profile;
+        out->acquisitions += p->acquisitions;
+        out->wait_ns += p->wait_ns;
+        out->hold_ns += p->hold_ns;
+        if (p->max_wait_ns > out->max_wait_ns) out->max_wait_ns = p->max_wait_ns;
+        out->validation_failures += p->validation_failures;
+        out->head_rescans += p->head_rescans;
+        out->parks += p->parks;
+    }
+    return true;
+}
+
+void skiplist_lock_profile_reset(void) {
+    memset(lock_profile_slots, 0, sizeof(lock_profile_slots));
+}
+
+#else
+
+bool skiplist_lock_profile(LockProfile* out) {
+    memset(out, 0, sizeof(*out));
+    return false;
+}
+
+void skiplist_lock_profile_reset(void) {
+}
+
+#endif // SKIPLIST_LOCK_PROFILE
+
+// ------------------------------------------------------------------------
+// Operation metrics (read by skiplist_metrics.c)
+// ------------------------------------------------------------------------
+#ifdef SKIPLIST_METRICS
+
+PaddedOpMetrics metrics_slots[MAX_INSTRUMENT_THREADS];
+
+bool instrument_op_metrics(OpMetrics* out) {
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < MAX_INSTRUMENT_THREADS; t++) {
+        OpMetrics* m = &metrics_slots[t].metrics;
+        for (int op = 0; op < METRICS_OPS; op++) {
+            out->count[op][0] += m->count[op][0];
+            out->count[op][1] += m->count[op][1];
+            out->sum_ns[op] += m->sum_ns[op];
+            for (int b = 0; b < METRICS_BUCKETS; b++) {
+                out->buckets[op][b] += m->buckets[op][b];
+            }
+        }
+    }
+    return true;
+}
+
+void skiplist_metrics_reset(void) {
+    memset(metrics_slots, 0, sizeof(metrics_slots));
+}
+
+#else
+
+bool instrument_op_metrics(OpMetrics* out) {
+    memset(out, 0, sizeof(*out));
+    return false;
+}
+
+void skiplist_metrics_reset(void) {
+}
+
+#endif // SKIPLIST_METRICS
+
+// ------------------------------------------------------------------------
+// Event ring buffers and Chrome trace export
+// ------------------------------------------------------------------------
+#ifdef SKIPLIST_TRACE
+
+__thread TraceRing* trace_ring = NULL;
+static _Atomic(TraceRing*) trace_rings = NULL;
+
+static const char* trace_event_names[TRACE_EV_COUNT] = {
+    [TRACE_EV_INSERT]          = "insert",
+    [TRACE_EV_DELETE]          = "delete",
+    [TRACE_EV_CONTAINS]        = "contains",
+    [TRACE_EV_LOCK_WAIT]       = "lock_wait",
+    [TRACE_EV_LOCK_HOLD]       = "lock_hold",
+    [TRACE_EV_CAS_FAIL]        = "cas_fail",
+    [TRACE_EV_FIND_RESTART]    = "find_restart",
+    [TRACE_EV_VALIDATION_FAIL] = "validation_fail",
+    [TRACE_EV_BACKOFF]         = "backoff",
+};
+
+TraceRing* trace_ring_attach(void) {
+    TraceRing* ring = (TraceRing*)calloc(1, sizeof(TraceRing));
+    if (!ring) {
+        fprintf(stderr, "Failed to allocate trace ring\n");
+        exit(1);
+    }
+    ring->tid = instrument_thread_slot();
+    
+    TraceRing* head = atomic_load(&trace_rings);
+    do {
+        ring->next = head;
+    } while (!atomic_compare_exchange_weak(&trace_rings, &head, ring));
+    
+    trace_ring = ring;
+    return ring;
+}
+
+void skiplist_trace_reset(void) {
+    for (TraceRing* r = atomic_load(&trace_rings); r; r = r->next) {
+        atomic_store(&r->head, 0);
+    }
+}
+
+static const char* trace_category(int type) {
+    switch (type) {
+        case TRACE_EV_INSERT:
+        case TRACE_EV_DELETE:
+        case TRACE_EV_CONTAINS:   return "op";
+        case TRACE_EV_LOCK_WAIT:
+        case TRACE_EV_LOCK_HOLD:  return "lock";
+        default:                  return "retry";
+    }
+}
+
+// Begin/end pairs become complete ("X") events; a begin whose end is not in
+// the ring (or an end whose begin was overwritten) is dropped.
+#define TRACE_MAX_DEPTH 8
+
+static void dump_ring(FILE* out, TraceRing* ring, uint64_t t0, bool* first) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint64_t count = head < TRACE_RING_EVENTS ? head : TRACE_RING_EVENTS;
+    TraceEvent* open[TRACE_MAX_DEPTH];
+    int depth = 0;
+    
+    for (uint64_t i = head - count; i < head; i++) {
+        TraceEvent* ev = &ring->events[i & (TRACE_RING_EVENTS - 1)];
+        
+        if (ev->phase == TRACE_BEGIN) {
+            if (depth < TRACE_MAX_DEPTH) open[depth++] = ev;
+            continue;
+        }
+        
+        if (ev->phase == TRACE_END) {
+            if (depth == 0 || open[depth - 1]->type != ev->type) {
+                depth = 0;  // Unmatched: the begin was overwritten
+                continue;
+            }
+            TraceEvent* begin = open[--depth];
+            fprintf(out, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                    "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"key\":%d,\"result\":%d}}",
+                    *first ? "" : ",", trace_event_names[ev->type], trace_category(ev->type),
+                    ring->tid, (begin->ts_ns - t0) / 1e3, (ev->ts_ns - begin->ts_ns) / 1e3,
+                    ev->key, ev->arg);
+        } else {
+            fprintf(out, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,"
+                    "\"tid\":%d,\"ts\":%.3f,\"args\":{\"key\":%d,\"arg\":%d}}",
+                    *first ? "" : ",", trace_event_names[ev->type], trace_category(ev->type),
+                    ring->tid, (ev->ts_ns - t0) / 1e3, ev->key, ev->arg);
+        }
+        *first = false;
+    }
+}
+
+bool skiplist_trace_dump(const char* path) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        perror("Failed to open trace file");
+        return false;
+    }
+    
+    // Timestamps are written relative to the oldest retained event
+    uint64_t t0 = UINT64_MAX;
+    for (TraceRing* r = atomic_load(&trace_rings); r; r = r->next) {
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (head == 0) continue;
+        uint64_t oldest = head < TRACE_RING_EVENTS ? 0 : head - TRACE_RING_EVENTS;
+        uint64_t ts = r->events[oldest & (TRACE_RING_EVENTS - 1)].ts_ns;
+        if (ts < t0) t0 = ts;
+    }
+    
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (TraceRing* r = atomic_load(&trace_rings); r; r = r->next) {
+        dump_ring(out, r, t0, &first);
+    }
+    fprintf(out, "\n]}\n");
+    
+    return fclose(out) == 0;
+}
+
+#else
+
+bool skiplist_trace_dump(const char* path) {
+    (void)path;
+    return false;
+}
+
+void skiplist_trace_reset(void) {
+}
+
+#endif // SKIPLIST_TRACE
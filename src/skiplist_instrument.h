@@ -0,0 +1,321 @@
+#ifndef SKIPLIST_INSTRUMENT_H
+#define SKIPLIST_INSTRUMENT_H
+
+#include "skiplist_common.h"
+#include <time.h>
+
+/**
+ * Internal instrumentation hooks for the skip list implementations.
+ *
+ * Apart from node accounting and the USDT NOPs, every hook expands to
+ * nothing unless its feature macro is defined, so the default build pays
+ * nothing for the rest. Counters live
+ * in per-thread slots padded to a cache line; a thread claims its slot on
+ * first use and only ever writes its own slot.
+ */
+
+// Slot of the calling thread in [0, MAX_INSTRUMENT_THREADS).
+// Threads beyond MAX_INSTRUMENT_THREADS share slots (counts stay
+// approximately right but are no longer race-free).
+extern __thread int instrument_slot;
+int instrument_register_thread(void);
+
+static inline int instrument_thread_slot(void) {
+    int slot = instrument_slot;
+    return slot >= 0 ? slot : instrument_register_thread();
+}
+
+// ------------------------------------------------------------------------
+// Static tracepoints (USDT, provider "skiplist")
+// Compiled in whenever <sys/sdt.h> is available; each probe is a single
+// NOP plus an ELF note until perf/bpftrace attaches to it, e.g.
+//   bpftrace -e 'usdt:./bin/benchmark:skiplist:cas_fail { @[arg0] = count(); }'
+// Build with -DSKIPLIST_NO_USDT to drop them entirely.
+// ------------------------------------------------------------------------
+#if !defined(SKIPLIST_NO_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SKIPLIST_HAVE_USDT 1
+#endif
+#endif
+
+#ifdef SKIPLIST_HAVE_USDT
+#define TRACE_PROBE1(name, a)       DTRACE_PROBE1(skiplist, name, a)
+#define TRACE_PROBE2(name, a, b)    DTRACE_PROBE2(skiplist, name, a, b)
+#else
+#define TRACE_PROBE1(name, a)       ((void)0)
+#define TRACE_PROBE2(name, a, b)    ((void)0)
+#endif
+
+// ------------------------------------------------------------------------
+// Node allocation accounting (always compiled in: one thread-local
+// increment next to a malloc/free is lost in the noise)
+// ------------------------------------------------------------------------
+typedef struct {
+    MemoryStats stats;
+} __attribute__((aligned(CACHE_LINE_SIZE))) PaddedMemoryStats;
+
+extern PaddedMemoryStats memory_slots[MAX_INSTRUMENT_THREADS];
+
+#define MEMORY_INC(field) \
+    (memory_slots[instrument_thread_slot()].stats.field++)
+
+// ------------------------------------------------------------------------
+// Lock-free contention counters (SKIPLIST_STATS)
+// ------------------------------------------------------------------------
+#ifdef SKIPLIST_STATS
+
+typedef struct {
+    ContentionStats stats;
+} __attribute__((aligned(CACHE_LINE_SIZE))) PaddedContentionStats;
+
+extern PaddedContentionStats contention_slots[MAX_INSTRUMENT_THREADS];
+
+#define CONTENTION_INC(field) \
+    (contention_slots[instrument_thread_slot()].stats.field++)
+#define CONTENTION_INC_LEVEL(field, level) \
+    (contention_slots[instrument_thread_slot()].stats.field[(level)]++)
+#define CONTENTION_ADD(field, n) \
+    (contention_slots[instrument_thread_slot()].stats.field += (n))
+
+#else
+
+#define CONTENTION_INC(field)              ((void)0)
+#define CONTENTION_INC_LEVEL(field, level) ((void)0)
+#define CONTENTION_ADD(field, n)           ((void)0)
+
+#endif // SKIPLIST_STATS
+
+// ------------------------------------------------------------------------
+// Lock acquisition / hold timing (SKIPLIST_LOCK_PROFILE)
+// Neither the coarse nor the fine variant ever holds two profiled locks at
+// once, so a single per-thread hold timestamp is enough. (The coarse join
+// also holds the lock of the list it consumes, taken unprofiled.)
+// ------------------------------------------------------------------------
+static inline uint64_t instrument_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef SKIPLIST_LOCK_PROFILE
+
+typedef struct {
+    LockProfile profile;
+    uint64_t hold_start_ns;
+} __attribute__((aligned(CACHE_LINE_SIZE))) PaddedLockProfile;
+
+extern PaddedLockProfile lock_profile_slots[MAX_INSTRUMENT_THREADS];
+
+static inline uint64_t lock_profile_wait_begin(void) {
+    return instrument_now_ns();
+}
+
+static inline void lock_profile_acquired(uint64_t start) {
+    PaddedLockProfile* slot = &lock_profile_slots[instrument_thread_slot()];
+    uint64_t acquired = instrument_now_ns();
+    uint64_t wait = acquired - start;
+    slot->profile.acquisitions++;
+    slot->profile.wait_ns += wait;
+    if (wait > slot->profile.max_wait_ns) slot->profile.max_wait_ns = wait;
+    slot->hold_start_ns = acquired;
+}
+
+static inline void lock_profile_release(void) {
+    PaddedLockProfile* slot = &lock_profile_slots[instrument_thread_slot()];
+    slot->profile.hold_ns += instrument_now_ns() - slot->hold_start_ns;
+}
+
+#define LOCK_PROFILE_INC(field) \
+    (lock_profile_slots[instrument_thread_slot()].profile.field++)
+
+#else
+
+static inline uint64_t lock_profile_wait_begin(void) { return 0; }
+static inline void lock_profile_acquired(uint64_t start) { (void)start; }
+static inline void lock_profile_release(void) {}
+
+#define LOCK_PROFILE_INC(field) ((void)0)
+
+#endif // SKIPLIST_LOCK_PROFILE
+
+// ------------------------------------------------------------------------
+// Per-thread event ring buffers (SKIPLIST_TRACE)
+// Each thread appends timestamped events to its own ring, overwriting the
+// oldest entries once TRACE_RING_EVENTS is exceeded. Only the owner writes;
+// skiplist_trace_dump() reads the rings once the workload has finished.
+// ------------------------------------------------------------------------
+typedef enum {
+    TRACE_EV_INSERT = 0,
+    TRACE_EV_DELETE,
+    TRACE_EV_CONTAINS,
+    TRACE_EV_LOCK_WAIT,
+    TRACE_EV_LOCK_HOLD,
+    TRACE_EV_CAS_FAIL,
+    TRACE_EV_FIND_RESTART,
+    TRACE_EV_VALIDATION_FAIL,
+    TRACE_EV_BACKOFF,
+    TRACE_EV_COUNT
+} TraceEventType;
+
+typedef enum {
+    TRACE_BEGIN = 'B',
+    TRACE_END = 'E',
+    TRACE_INSTANT = 'i'
+} TracePhase;
+
+#ifdef SKIPLIST_TRACE
+
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS (1 << 16)   // Per thread, must be a power of two
+#endif
+
+typedef struct {
+    uint64_t ts_ns;
+    uint8_t type;
+    uint8_t phase;
+    int16_t arg;      // Level, attempt or op result
+    int32_t key;
+} TraceEvent;
+
+typedef struct TraceRing {
+    _Atomic(uint64_t) head;   // Events ever written; published with release
+    int tid;                  // Instrument slot of the owning thread
+    struct TraceRing* next;   // Registry of all rings (push-only)
+    TraceEvent events[TRACE_RING_EVENTS];
+} TraceRing;
+
+extern __thread TraceRing* trace_ring;
+TraceRing* trace_ring_attach(void);
+
+static inline void trace_event(TraceEventType type, TracePhase phase, int key, int arg) {
+    TraceRing* ring = trace_ring ? trace_ring : trace_ring_attach();
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    TraceEvent* ev = &ring->events[head & (TRACE_RING_EVENTS - 1)];
+    ev->ts_ns = instrument_now_ns();
+    ev->type = (uint8_t)type;
+    ev->phase = (uint8_t)phase;
+    ev->arg = (int16_t)arg;
+    ev->key = key;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+#define TRACE_EVENT(type, phase, key, arg) trace_event((type), (phase), (key), (arg))
+
+#else
+
+#define TRACE_EVENT(type, phase, key, arg) ((void)0)
+
+#endif // SKIPLIST_TRACE
+
+// ------------------------------------------------------------------------
+// Operation counts and latency histograms (SKIPLIST_METRICS)
+// Bucket b counts latencies in (2^(b+5), 2^(b+6)] ns, matching the inclusive
+// Prometheus le bound; the first bucket also takes anything faster and the
+// last anything slower.
+// ------------------------------------------------------------------------
+#define METRICS_OPS 3              // insert, delete, contains (TRACE_EV_* order)
+#define METRICS_BUCKETS 26         // <= 64ns ... <= 2^30 ns (~1.07s), +Inf
+#define METRICS_MIN_SHIFT 6
+
+typedef struct {
+    uint64_t count[METRICS_OPS][2];          // [op][0 = failed, 1 = succeeded]
+    uint64_t sum_ns[METRICS_OPS];
+    uint64_t buckets[METRICS_OPS][METRICS_BUCKETS];
+} OpMetrics;
+
+#ifdef SKIPLIST_METRICS
+
+typedef struct {
+    OpMetrics metrics;
+} __attribute__((aligned(CACHE_LINE_SIZE))) PaddedOpMetrics;
+
+extern PaddedOpMetrics metrics_slots[MAX_INSTRUMENT_THREADS];
+
+static inline uint64_t metrics_op_begin(void) {
+    return instrument_now_ns();
+}
+
+static inline void metrics_op_end(int op, bool result, uint64_t start) {
+    uint64_t ns = instrument_now_ns() - start;
+    int bucket = ns <= 64 ? 0 : 64 - __builtin_clzll(ns - 1) - METRICS_MIN_SHIFT;
+    if (bucket >= METRICS_BUCKETS) bucket = METRICS_BUCKETS - 1;
+    
+    OpMetrics* m = &metrics_slots[instrument_thread_slot()].metrics;
+    m->count[op][result ? 1 : 0]++;
+    m->sum_ns[op] += ns;
+    m->buckets[op][bucket]++;
+}
+
+#else
+
+static inline uint64_t metrics_op_begin(void) { return 0; }
+static inline void metrics_op_end(int op, bool result, uint64_t start) {
+    (void)op; (void)result; (void)start;
+}
+
+#endif // SKIPLIST_METRICS
+
+// Sums all slots; false when built without SKIPLIST_METRICS
+bool instrument_op_metrics(OpMetrics* out);
+
+// ------------------------------------------------------------------------
+// Composite hooks used by the implementations. Each one feeds every
+// enabled backend (counters, lock profile, ring buffer, USDT).
+// ------------------------------------------------------------------------
+#define NOTE_CAS_FAILURE(level, key) do { \
+    CONTENTION_INC_LEVEL(cas_failures, (level)); \
+    TRACE_EVENT(TRACE_EV_CAS_FAIL, TRACE_INSTANT, (key), (level)); \
+    TRACE_PROBE2(cas_fail, (level), (key)); \
+} while (0)
+
+#define NOTE_FIND_RESTART(key) do { \
+    CONTENTION_INC(find_restarts); \
+    TRACE_EVENT(TRACE_EV_FIND_RESTART, TRACE_INSTANT, (key), 0); \
+    TRACE_PROBE1(find_restart, (key)); \
+} while (0)
+
+#define NOTE_BACKOFF(attempt) do { \
+    CONTENTION_INC(backoff_calls); \
+    TRACE_EVENT(TRACE_EV_BACKOFF, TRACE_INSTANT, 0, (attempt)); \
+    TRACE_PROBE1(backoff, (attempt)); \
+} while (0)
+
+// Fine-grained: post-lock validation failed. A failure at insert's level 0
+// retries the whole search; the others rescan one level from head, which is
+// what NOTE_HEAD_RESCAN counts.
+#define NOTE_VALIDATION_FAILURE(level, key) do { \
+    LOCK_PROFILE_INC(validation_failures); \
+    TRACE_EVENT(TRACE_EV_VALIDATION_FAIL, TRACE_INSTANT, (key), (level)); \
+} while (0)
+
+#define NOTE_HEAD_RESCAN() LOCK_PROFILE_INC(head_rescans)
+
+// Bracket every public insert/delete/contains (OP_BEGIN declares op_start_ns)
+#define OP_BEGIN(type, key) \
+    uint64_t op_start_ns = metrics_op_begin(); \
+    TRACE_EVENT((type), TRACE_BEGIN, (key), 0)
+#define OP_END(type, key, result) do { \
+    metrics_op_end((type), (result), op_start_ns); \
+    TRACE_EVENT((type), TRACE_END, (key), (result)); \
+} while (0)
+
+// The coarse and fine variants take and release every lock through these
+static inline void lock_acquire(SkipLock* lock) {
+    uint64_t start = lock_profile_wait_begin();
+    TRACE_EVENT(TRACE_EV_LOCK_WAIT, TRACE_BEGIN, 0, 0);
+    if (skiplock_lock(lock)) LOCK_PROFILE_INC(parks);
+    lock_profile_acquired(start);
+    TRACE_EVENT(TRACE_EV_LOCK_WAIT, TRACE_END, 0, 0);
+    TRACE_EVENT(TRACE_EV_LOCK_HOLD, TRACE_BEGIN, 0, 0);
+    TRACE_PROBE1(lock_acquire, lock);
+}
+
+static inline void lock_release(SkipLock* lock) {
+    lock_profile_release();
+    TRACE_EVENT(TRACE_EV_LOCK_HOLD, TRACE_END, 0, 0);
+    skiplock_unlock(lock);
+    TRACE_PROBE1(lock_release, lock);
+}
+
+#endif // SKIPLIST_INSTRUMENT_H
@@ -0,0 +1,71 @@
+#include "skiplist_lock.h"
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// Pauses before a waiter parks: roughly the cost of a sleep/wake round trip
+#ifndef SKIPLOCK_SPIN_LIMIT
+#define SKIPLOCK_SPIN_LIMIT 200
+#endif
+
+LockPolicy skiplock_policy = LOCK_POLICY_PARK;
+
+static const char* policy_names[] = {
+    [LOCK_POLICY_PARK] = "park",
+    [LOCK_POLICY_SPIN] = "spin",
+    [LOCK_POLICY_OMP] = "omp",
+};
+
+void skiplock_set_policy(LockPolicy policy) {
+    skiplock_policy = policy;
+}
+
+const char* skiplock_policy_name(LockPolicy policy) {
+    return policy_names[policy];
+}
+
+bool skiplock_parse_policy(const char* name, LockPolicy* policy) {
+    for (int p = 0; p < (int)(sizeof(policy_names) / sizeof(policy_names[0])); p++) {
+        if (strcmp(name, policy_names[p]) == 0) {
+            *policy = (LockPolicy)p;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool try_acquire(SkipLock* lock) {
+    int expected = 0;
+    return atomic_load_explicit(&lock->state, memory_order_relaxed) == 0 &&
+           atomic_compare_exchange_weak_explicit(&lock->state, &expected, 1,
+                                                 memory_order_acquire, memory_order_relaxed);
+}
+
+bool skiplock_lock_slow(SkipLock* lock) {
+    if (skiplock_policy == LOCK_POLICY_SPIN) {
+        while (!try_acquire(lock)) {
+            cpu_relax();
+        }
+        return false;
+    }
+
+    for (int i = 0; i < SKIPLOCK_SPIN_LIMIT; i++) {
+        if (try_acquire(lock)) return false;
+        cpu_relax();
+    }
+
+    // From here on the lock is taken as 2, since other sleepers may remain
+    // when we get it
+    bool parked = false;
+    while (atomic_exchange_explicit(&lock->state, 2, memory_order_acquire) != 0) {
+        // Returns immediately (EAGAIN) if the word changed from 2 meanwhile
+        syscall(SYS_futex, &lock->state, FUTEX_WAIT_PRIVATE, 2, NULL, NULL, 0);
+        parked = true;
+    }
+    return parked;
+}
+
+void skiplock_wake(SkipLock* lock) {
+    syscall(SYS_futex, &lock->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
@@ -1,4 +1,5 @@
 #include "skiplist_common.h"
+#include "skiplist_instrument.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <limits.h>
@@ -11,19 +12,15 @@
 #define YIELD_THRESHOLD 3
 #define MAX_RETRIES 100
 
-static inline void cpu_relax() {
-#if defined(__x86_64__) || defined(__i386__)
-    __builtin_ia32_pause();
-#elif defined(__aarch64__)
-    __asm__ __volatile__("yield");
-#else
-    __asm__ __volatile__("" ::: "memory");
-#endif
-}
+// A pop that walks past this many deleted nodes at the front of the list
+// unlinks them in one batch
+#define POP_CLEANUP_THRESHOLD 32
 
 static void backoff(int *attempt) {
     (*attempt)++;
+    NOTE_BACKOFF(*attempt);
     if (*attempt > YIELD_THRESHOLD) {
+        CONTENTION_INC(backoff_yields);
         sched_yield();
         return;
     }
@@ -47,11 +44,13 @@ SkipList* skiplist_create_lockfree(void) {
     
     atomic_init(&list->size, 0);
     list->maxLevel = MAX_LEVEL;
+    list->indexable = false;
     
     return list;
 }
 
 static bool find(SkipList* list, int key, Node** preds, Node** succs) {
+    TRACE_PROBE1(find, key);
 retry:
     Node* pred = list->head;
     
@@ -65,8 +64,11 @@ retry:
             while (IS_MARKED(succ)) {
                 Node* unmarked_succ = GET_UNMARKED(succ);
                 if (!atomic_compare_exchange_strong(&pred->next[level], &curr, unmarked_succ)) {
+                    NOTE_CAS_FAILURE(level, key);
+                    NOTE_FIND_RESTART(key);
                     goto retry;
                 }
+                CONTENTION_INC(helping_unlinks);
                 curr = unmarked_succ;
                 if (curr == list->tail) break;
                 succ = atomic_load(&curr->next[level]);
@@ -89,7 +91,7 @@ retry:
     return (succs[0] != list->tail && succs[0]->key == key);
 }
 
-bool skiplist_insert_lockfree(SkipList* list, int key, int value) {
+static bool insert_lockfree(SkipList* list, int key, int value) {
     Node* preds[MAX_LEVEL + 1];
     Node* succs[MAX_LEVEL + 1];
     int attempt = 0;
@@ -118,12 +120,13 @@ bool skiplist_insert_lockfree(SkipList* list, int key, int value) {
         Node* succ = succs[0];
         
         if (!atomic_compare_exchange_strong(&pred->next[0], &succ, newNode)) {
-            omp_destroy_lock(&newNode->lock);
-            free(newNode);
+            NOTE_CAS_FAILURE(0, key);
+            free_node(newNode);
             backoff(&attempt);
             continue;
         }
         
+        TRACE_PROBE2(insert, key, topLevel);
         atomic_fetch_add(&list->size, 1);
         
         // Build tower with validation
@@ -135,19 +138,38 @@ bool skiplist_insert_lockfree(SkipList* list, int key, int value) {
                 Node* curr_next = atomic_load(&newNode->next[0]);
                 if (IS_MARKED(curr_next)) {
                     // Node was deleted, stop building
+                    CONTENTION_INC(tower_abandons);
                     goto tower_done;
                 }
                 
                 pred = preds[i];
                 succ = succs[i];
                 
+                // Point the new node at the current successor first: after a
+                // refresh at a lower level, next[i] still holds the successor
+                // from the first find(), and linking with it would drop every
+                // node inserted in between from this level. CAS, not store,
+                // so a concurrent delete's mark is never overwritten.
+                Node* old_next = atomic_load(&newNode->next[i]);
+                if (old_next != succ &&
+                    (IS_MARKED(old_next) ||
+                     !atomic_compare_exchange_strong(&newNode->next[i], &old_next, succ))) {
+                    CONTENTION_INC(tower_abandons);
+                    goto tower_done;
+                }
+                
                 if (atomic_compare_exchange_strong(&pred->next[i], &succ, newNode)) {
                     break; // Success at this level
                 }
+                NOTE_CAS_FAILURE(i, key);
+                if (tower_attempts == 3) {
+                    // Stop here rather than leave a gap in the tower
+                    CONTENTION_INC(tower_levels_skipped);
+                    goto tower_done;
+                }
                 
-                // FIX: Refresh preds/succs AND update newNode's next pointer
+                // Refresh preds/succs; next[i] is updated on the next attempt
                 find(list, key, preds, succs);
-                atomic_store(&newNode->next[i], succs[i]);
             }
         }
         
@@ -156,10 +178,11 @@ bool skiplist_insert_lockfree(SkipList* list, int key, int value) {
         return true;
     }
     
+    CONTENTION_INC(retries_exhausted);
     return false; // Max retries exceeded
 }
 
-bool skiplist_delete_lockfree(SkipList* list, int key) {
+static bool delete_lockfree(SkipList* list, int key) {
     Node* preds[MAX_LEVEL + 1];
     Node* succs[MAX_LEVEL + 1];
     int attempt = 0;
@@ -173,15 +196,21 @@ bool skiplist_delete_lockfree(SkipList* list, int key) {
         
         // Mark from top to bottom
         for (int i = victim->topLevel; i >= 0; i--) {
-            Node* succ;
-            do {
-                succ = atomic_load(&victim->next[i]);
+            Node* succ = atomic_load(&victim->next[i]);
+            while (true) {
                 if (IS_MARKED(succ)) {
                     // Already marked at this level
                     if (i == 0) return false; // Someone else deleted
                     break;
                 }
-            } while (!atomic_compare_exchange_strong(&victim->next[i], &succ, GET_MARKED(succ)));
+                if (atomic_compare_exchange_strong(&victim->next[i], &succ, GET_MARKED(succ))) {
+                    if (i == 0) {
+                        TRACE_PROBE1(delete, key);  // Linearization point
+                    }
+                    break;
+                }
+                NOTE_CAS_FAILURE(i, key);
+            }
         }
         
         // Physical removal (helping)
@@ -191,10 +220,234 @@ bool skiplist_delete_lockfree(SkipList* list, int key) {
         return true;
     }
     
+    CONTENTION_INC(retries_exhausted);
     return false;
 }
 
-bool skiplist_contains_lockfree(SkipList* list, int key) {
+// Delete-min. Pops only walk level 0: they skip the prefix of deleted
+// nodes and claim the first live node by marking its level-0 pointer. That
+// mark is the linearization point, the same one delete() uses, so a pop and
+// a delete of the same key cannot both win.
+//
+// Every pointer inside the deleted prefix is marked, so an insert of a
+// smaller key can only link at head->next[0], ahead of where the pop
+// started walking. A strict pop therefore re-reads head->next[0] right
+// before its claim CAS and starts over if it changed. When it has not, the
+// node about to be claimed was the smallest live key at that re-read, and
+// the pop is linearized there. Each restart means an insert or an unlink
+// made progress at the head, so pops stay lock-free. The same check guards
+// the empty result at the tail.
+//
+// find() from inserts and deletes helps unlink prefix nodes one at a time.
+// Pop-only phases run no find(), so once a pop walks past
+// POP_CLEANUP_THRESHOLD deleted nodes it swings head->next[0] past the whole
+// prefix with one CAS; find() then removes the claimed node and the stale
+// upper-level links.
+//
+// Claims the first live node at or after `curr` on level 0 and marks its
+// tower. Returns NULL at the tail; *skipped counts the deleted nodes passed.
+// With `first` set, nothing is claimed unless head->next[0] still equals
+// `first`; a changed head sets *stale and returns NULL.
+static Node* claim_first_live(SkipList* list, Node* curr, Node* first, int* skipped, bool* stale) {
+    Node* victim = NULL;
+    
+    while (curr != list->tail) {
+        Node* succ = atomic_load(&curr->next[0]);
+        if (IS_MARKED(succ)) {
+            (*skipped)++;
+            curr = GET_UNMARKED(succ);
+            continue;
+        }
+        if (first && atomic_load(&list->head->next[0]) != first) {
+            *stale = true;
+            return NULL;
+        }
+        if (atomic_compare_exchange_strong(&curr->next[0], &succ, GET_MARKED(succ))) {
+            victim = curr;
+            break;
+        }
+        // Lost to another pop/delete, or an insert linked behind curr: recheck curr
+        NOTE_CAS_FAILURE(0, curr->key);
+    }
+    if (!victim) {
+        if (first && atomic_load(&list->head->next[0]) != first) *stale = true;
+        return NULL;
+    }
+    
+    TRACE_PROBE1(delete, victim->key);
+    atomic_fetch_sub(&list->size, 1);
+    
+    // Mark the rest of the tower so find() unlinks it at every level
+    for (int i = victim->topLevel; i >= 1; i--) {
+        Node* succ = atomic_load(&victim->next[i]);
+        while (!IS_MARKED(succ) &&
+               !atomic_compare_exchange_strong(&victim->next[i], &succ, GET_MARKED(succ))) {
+            NOTE_CAS_FAILURE(i, victim->key);
+        }
+    }
+    return victim;
+}
+
+static bool pop_min_lockfree(SkipList* list, int* key, int* value) {
+    Node* first;
+    Node* victim;
+    int skipped;
+    bool stale;
+    
+    do {
+        first = atomic_load(&list->head->next[0]);  // head is never marked
+        skipped = 0;
+        stale = false;
+        victim = claim_first_live(list, first, first, &skipped, &stale);
+        CONTENTION_ADD(pop_prefix_skips, skipped);
+    } while (stale);
+    if (!victim) return false;
+    
+    if (skipped >= POP_CLEANUP_THRESHOLD &&
+        atomic_compare_exchange_strong(&list->head->next[0], &first, victim)) {
+        CONTENTION_INC(pop_cleanups);
+        Node* preds[MAX_LEVEL + 1];
+        Node* succs[MAX_LEVEL + 1];
+        find(list, victim->key, preds, succs);
+    }
+    
+    *key = victim->key;
+    *value = victim->value;
+    return true;
+}
+
+// Relaxed delete-min (SprayList, Alistarh et al.). For p threads a spray
+// starts at level log2(p) + 1 and walks a random 0..log2(p)^3 nodes
+// forward, then descends max(1, log2(log2(p))) levels and repeats down to
+// level 0. It lands, with high probability, among the first O(p log^3 p)
+// keys, so concurrent pops spread out instead of all fighting over the
+// head. The first live node at or after the landing point is claimed as in
+// pop_min and unlinked with find(). One pop in p is a strict pop_min, which
+// also batch-unlinks the deleted prefix the sprays leave behind.
+static __thread unsigned int spray_seed = 0;
+
+static bool pop_approx_min_lockfree(SkipList* list, int threads, int* key, int* value) {
+    if (threads <= 1) return pop_min_lockfree(list, key, value);
+    if (spray_seed == 0) spray_seed = (unsigned int)(uintptr_t)&spray_seed | 1;
+    if (rand_r(&spray_seed) % threads == 0) return pop_min_lockfree(list, key, value);
+    
+    int log_p = 31 - __builtin_clz((unsigned int)threads);
+    int log_log_p = log_p > 1 ? 31 - __builtin_clz((unsigned int)log_p) : 0;
+    int height = log_p + 1 < list->maxLevel ? log_p + 1 : list->maxLevel;
+    int max_jump = log_p * log_p * log_p;
+    int descend = log_log_p > 1 ? log_log_p : 1;
+    
+    Node* pred = list->head;
+    for (int level = height; ; level = level > descend ? level - descend : 0) {
+        int jump = rand_r(&spray_seed) % (max_jump + 1);
+        for (int i = 0; i < jump; i++) {
+            Node* next = GET_UNMARKED(atomic_load(&pred->next[level]));
+            if (next == list->tail) break;
+            pred = next;
+        }
+        if (level == 0) break;
+    }
+    
+    Node* start = pred == list->head ? GET_UNMARKED(atomic_load(&pred->next[0])) : pred;
+    int skipped = 0;
+    Node* victim = claim_first_live(list, start, NULL, &skipped, NULL);
+    CONTENTION_ADD(pop_prefix_skips, skipped);
+    if (!victim) {
+        // Landed past the last live key; the smaller keys may still be there
+        return pop_min_lockfree(list, key, value);
+    }
+    
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    find(list, victim->key, preds, succs);
+    
+    *key = victim->key;
+    *value = victim->value;
+    return true;
+}
+
+// Deletes every key in [from, to) and returns how many this call removed.
+// One find() locates the run. Its nodes are then marked in key order, tower
+// first, as in delete_lockfree. A marked node's next pointers never change
+// again, so the run is unlinked with one CAS per level from preds[l] to the
+// first node past it. Where that CAS fails (an insert or another unlink
+// touched preds[l]), one find(to) snips what is left. Keys inserted into
+// the range while this runs may survive it.
+static int delete_range_lockfree(SkipList* list, int from, int to) {
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    int deleted = 0;
+    
+    if (from >= to) return 0;
+    find(list, from, preds, succs);
+    
+    for (Node* curr = succs[0]; curr != list->tail && curr->key < to;
+         curr = GET_UNMARKED(atomic_load(&curr->next[0]))) {
+        for (int i = curr->topLevel; i >= 1; i--) {
+            Node* succ = atomic_load(&curr->next[i]);
+            while (!IS_MARKED(succ) &&
+                   !atomic_compare_exchange_strong(&curr->next[i], &succ, GET_MARKED(succ))) {
+                NOTE_CAS_FAILURE(i, curr->key);
+            }
+        }
+        Node* succ = atomic_load(&curr->next[0]);
+        while (!IS_MARKED(succ)) {
+            if (atomic_compare_exchange_strong(&curr->next[0], &succ, GET_MARKED(succ))) {
+                TRACE_PROBE1(delete, curr->key);  // Linearization point for this key
+                deleted++;
+                break;
+            }
+            NOTE_CAS_FAILURE(0, curr->key);
+        }
+    }
+    
+    bool leftovers = false;
+    for (int level = list->maxLevel; level >= 0; level--) {
+        Node* first = atomic_load(&preds[level]->next[level]);
+        if (IS_MARKED(first)) {
+            leftovers = true;  // preds[level] was deleted meanwhile
+            continue;
+        }
+        Node* curr = first;
+        while (curr != list->tail && curr->key < to) {
+            Node* succ = atomic_load(&curr->next[level]);
+            if (!IS_MARKED(succ)) break;
+            curr = GET_UNMARKED(succ);
+        }
+        if (curr == first) continue;
+        if (curr != list->tail && curr->key < to) leftovers = true;
+        if (!atomic_compare_exchange_strong(&preds[level]->next[level], &first, curr)) {
+            NOTE_CAS_FAILURE(level, from);
+            leftovers = true;
+        }
+    }
+    if (leftovers) find(list, to, preds, succs);
+    
+    atomic_fetch_sub(&list->size, deleted);
+    return deleted;
+}
+
+// Live keys in [from, to): a read-only descent to `from`, then a walk on
+// level 0. Not a snapshot under concurrent updates.
+static int count_range_lockfree(SkipList* list, int from, int to) {
+    Node* pred = list->head;
+    int count = 0;
+    
+    for (int level = list->maxLevel; level >= 0; level--) {
+        Node* curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        while (curr != list->tail && curr->key < from) {
+            pred = curr;
+            curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        }
+    }
+    for (Node* curr = GET_UNMARKED(atomic_load(&pred->next[0])); curr != list->tail && curr->key < to;
+         curr = GET_UNMARKED(atomic_load(&curr->next[0]))) {
+        if (!IS_MARKED(atomic_load(&curr->next[0]))) count++;
+    }
+    return count;
+}
+
+static bool contains_lockfree(SkipList* list, int key) {
     Node* pred = list->head;
     
     for (int level = list->maxLevel; level >= 0; level--) {
@@ -226,13 +479,88 @@ bool skiplist_contains_lockfree(SkipList* list, int key) {
             !IS_MARKED(atomic_load(&curr->next[0])));
 }
 
+// Public entry points: bracket each operation for the instrumentation hooks
+bool skiplist_insert_lockfree(SkipList* list, int key, int value) {
+    OP_BEGIN(TRACE_EV_INSERT, key);
+    bool inserted = insert_lockfree(list, key, value);
+    OP_END(TRACE_EV_INSERT, key, inserted);
+    return inserted;
+}
+
+bool skiplist_delete_lockfree(SkipList* list, int key) {
+    OP_BEGIN(TRACE_EV_DELETE, key);
+    bool deleted = delete_lockfree(list, key);
+    OP_END(TRACE_EV_DELETE, key, deleted);
+    return deleted;
+}
+
+bool skiplist_contains_lockfree(SkipList* list, int key) {
+    OP_BEGIN(TRACE_EV_CONTAINS, key);
+    bool found = contains_lockfree(list, key);
+    OP_END(TRACE_EV_CONTAINS, key, found);
+    return found;
+}
+
+bool skiplist_pop_min_lockfree(SkipList* list, int* key, int* value) {
+    OP_BEGIN(TRACE_EV_DELETE, INT_MIN);
+    bool popped = pop_min_lockfree(list, key, value);
+    OP_END(TRACE_EV_DELETE, popped ? *key : INT_MIN, popped);
+    return popped;
+}
+
+bool skiplist_pop_approx_min_lockfree(SkipList* list, int threads, int* key, int* value) {
+    OP_BEGIN(TRACE_EV_DELETE, INT_MIN);
+    bool popped = pop_approx_min_lockfree(list, threads, key, value);
+    OP_END(TRACE_EV_DELETE, popped ? *key : INT_MIN, popped);
+    return popped;
+}
+
+int skiplist_delete_range_lockfree(SkipList* list, int from, int to) {
+    OP_BEGIN(TRACE_EV_DELETE, from);
+    int deleted = delete_range_lockfree(list, from, to);
+    OP_END(TRACE_EV_DELETE, from, deleted > 0);
+    return deleted;
+}
+
+int skiplist_count_range_lockfree(SkipList* list, int from, int to) {
+    OP_BEGIN(TRACE_EV_CONTAINS, from);
+    int count = count_range_lockfree(list, from, to);
+    OP_END(TRACE_EV_CONTAINS, from, count > 0);
+    return count;
+}
+
+bool skiplist_find_lockfree(SkipList* list, int key) {
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    return find(list, key, preds, succs);
+}
+
+void skiplist_backoff_lockfree(int* attempt) {
+    backoff(attempt);
+}
+
+// Quiesced: no other thread may touch either list during the call. find()
+// also unlinks deleted nodes on the path, so the cut links are all live.
+SkipList* skiplist_split_lockfree(SkipList* list, int key) {
+    Node* preds[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    SkipList* into = skiplist_create_lockfree();
+    
+    find(list, key, preds, succs);
+    split_at_preds(list, into, preds, -1);
+    return into;
+}
+
+bool skiplist_join_lockfree(SkipList* list, SkipList* other) {
+    Node* lasts[MAX_LEVEL + 1];
+    Node* succs[MAX_LEVEL + 1];
+    
+    if (list == other) return false;
+    find(list, INT_MAX, lasts, succs);
+    return join_at_lasts(list, other, lasts);
+}
+
 void skiplist_destroy_lockfree(SkipList* list) {
-    Node* curr = list->head;
-    while (curr) {
-        Node* next = GET_UNMARKED(atomic_load(&curr->next[0]));
-        omp_destroy_lock(&curr->lock);
-        free(curr);
-        curr = next;
-    }
+    free_all_nodes(list);
     free(list);
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "skiplist_common.h"
+#include "skiplist_instrument.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Prometheus Exposition-Format Metrics
+ *
+ * A snapshot sums the per-thread instrumentation slots (a few hundred
+ * cache lines, no locks, writers are never stopped) and renders them as
+ * text format 0.0.4. Counters read from other threads' slots may be a few
+ * increments stale, which is fine for scraping.
+ */
+
+static const char* op_names[METRICS_OPS] = { "insert", "delete", "contains" };
+
+static void write_op_metrics(FILE* out, const char* impl, OpMetrics* m) {
+    fprintf(out, "# HELP skiplist_operations_total Completed operations by type and outcome.\n");
+    fprintf(out, "# TYPE skiplist_operations_total counter\n");
+    for (int op = 0; op < METRICS_OPS; op++) {
+        fprintf(out, "skiplist_operations_total{impl=\"%s\",op=\"%s\",result=\"success\"} %lu\n",
+                impl, op_names[op], (unsigned long)m->count[op][1]);
+        fprintf(out, "skiplist_operations_total{impl=\"%s\",op=\"%s\",result=\"failure\"} %lu\n",
+                impl, op_names[op], (unsigned long)m->count[op][0]);
+    }
+
+    fprintf(out, "# HELP skiplist_operation_duration_seconds Operation latency.\n");
+    fprintf(out, "# TYPE skiplist_operation_duration_seconds histogram\n");
+    for (int op = 0; op < METRICS_OPS; op++) {
+        uint64_t cumulative = 0;
+        for (int b = 0; b < METRICS_BUCKETS; b++) {
+            cumulative += m->buckets[op][b];
+            if (b == METRICS_BUCKETS - 1) {
+                fprintf(out, "skiplist_operation_duration_seconds_bucket{impl=\"%s\",op=\"%s\",le=\"+Inf\"} %lu\n",
+                        impl, op_names[op], (unsigned long)cumulative);
+            } else {
+                double le = (double)(1ull << (b + METRICS_MIN_SHIFT)) / 1e9;
+                fprintf(out, "skiplist_operation_duration_seconds_bucket{impl=\"%s\",op=\"%s\",le=\"%.9g\"} %lu\n",
+                        impl, op_names[op], le, (unsigned long)cumulative);
+            }
+        }
+        fprintf(out, "skiplist_operation_duration_seconds_sum{impl=\"%s\",op=\"%s\"} %.9f\n",
+                impl, op_names[op], m->sum_ns[op] / 1e9);
+        fprintf(out, "skiplist_operation_duration_seconds_count{impl=\"%s\",op=\"%s\"} %lu\n",
+                impl, op_names[op], (unsigned long)cumulative);
+    }
+}
+
+static void write_contention_metrics(FILE* out, const char* impl, ContentionStats* c) {
+    fprintf(out, "# HELP skiplist_cas_failures_total Failed CAS attempts by level.\n");
+    fprintf(out, "# TYPE skiplist_cas_failures_total counter\n");
+    for (int level = 0; level <= MAX_LEVEL; level++) {
+        fprintf(out, "skiplist_cas_failures_total{impl=\"%s\",level=\"%d\"} %lu\n",
+                impl, level, (unsigned long)c->cas_failures[level]);
+    }
+
+    struct { const char* name; const char* help; uint64_t value; } counters[] = {
+        { "skiplist_find_restarts_total", "find() restarts from head.", c->find_restarts },
+        { "skiplist_helping_unlinks_total", "Marked nodes unlinked by helping.", c->helping_unlinks },
+        { "skiplist_backoff_total", "backoff() calls.", c->backoff_calls },
+        { "skiplist_backoff_yields_total", "backoff() calls that yielded the CPU.", c->backoff_yields },
+        { "skiplist_tower_abandons_total", "Towers abandoned because the node was deleted.", c->tower_abandons },
+        { "skiplist_tower_levels_skipped_total", "Towers cut short after a level failed 3 link attempts.", c->tower_levels_skipped },
+        { "skiplist_retries_exhausted_total", "Operations that gave up after MAX_RETRIES.", c->retries_exhausted },
+        { "skiplist_pop_prefix_skips_total", "Deleted nodes walked past by pop_min.", c->pop_prefix_skips },
+        { "skiplist_pop_cleanups_total", "Deleted prefixes unlinked by one head CAS.", c->pop_cleanups },
+    };
+    for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+        fprintf(out, "# HELP %s %s\n# TYPE %s counter\n%s{impl=\"%s\"} %lu\n",
+                counters[i].name, counters[i].help, counters[i].name,
+                counters[i].name, impl, (unsigned long)counters[i].value);
+    }
+}
+
+static void write_lock_metrics(FILE* out, const char* impl, LockProfile* p) {
+    fprintf(out, "# HELP skiplist_lock_acquisitions_total Lock acquisitions.\n");
+    fprintf(out, "# TYPE skiplist_lock_acquisitions_total counter\n");
+    fprintf(out, "skiplist_lock_acquisitions_total{impl=\"%s\"} %lu\n", impl, (unsigned long)p->acquisitions);
+    fprintf(out, "# HELP skiplist_lock_wait_seconds_total Time spent waiting for locks.\n");
+    fprintf(out, "# TYPE skiplist_lock_wait_seconds_total counter\n");
+    fprintf(out, "skiplist_lock_wait_seconds_total{impl=\"%s\"} %.9f\n", impl, p->wait_ns / 1e9);
+    fprintf(out, "# HELP skiplist_lock_hold_seconds_total Time locks were held.\n");
+    fprintf(out, "# TYPE skiplist_lock_hold_seconds_total counter\n");
+    fprintf(out, "skiplist_lock_hold_seconds_total{impl=\"%s\"} %.9f\n", impl, p->hold_ns / 1e9);
+    fprintf(out, "# HELP skiplist_lock_parks_total Lock acquisitions that slept on the futex.\n");
+    fprintf(out, "# TYPE skiplist_lock_parks_total counter\n");
+    fprintf(out, "skiplist_lock_parks_total{impl=\"%s\"} %lu\n", impl, (unsigned long)p->parks);
+    fprintf(out, "# HELP skiplist_validation_failures_total Failed post-lock validations.\n");
+    fprintf(out, "# TYPE skiplist_validation_failures_total counter\n");
+    fprintf(out, "skiplist_validation_failures_total{impl=\"%s\"} %lu\n", impl,
+            (unsigned long)p->validation_failures);
+}
+
+static void write_memory_metrics(FILE* out, const char* impl, SkipList* list) {
+    MemoryStats mem;
+    skiplist_memory_stats(&mem);
+
+    fprintf(out, "# HELP skiplist_size Live keys in the list.\n");
+    fprintf(out, "# TYPE skiplist_size gauge\n");
+    fprintf(out, "skiplist_size{impl=\"%s\"} %d\n", impl, atomic_load(&list->size));
+    fprintf(out, "# HELP skiplist_nodes_allocated_total Nodes allocated (process-wide).\n");
+    fprintf(out, "# TYPE skiplist_nodes_allocated_total counter\n");
+    fprintf(out, "skiplist_nodes_allocated_total{impl=\"%s\"} %lu\n", impl, (unsigned long)mem.nodes_allocated);
+    fprintf(out, "# HELP skiplist_nodes_freed_total Nodes freed (process-wide).\n");
+    fprintf(out, "# TYPE skiplist_nodes_freed_total counter\n");
+    fprintf(out, "skiplist_nodes_freed_total{impl=\"%s\"} %lu\n", impl, (unsigned long)mem.nodes_freed);
+    fprintf(out, "# HELP skiplist_node_bytes Bytes held by allocated, unfreed nodes.\n");
+    fprintf(out, "# TYPE skiplist_node_bytes gauge\n");
+    fprintf(out, "skiplist_node_bytes{impl=\"%s\"} %lu\n", impl,
+            (unsigned long)((mem.nodes_allocated - mem.nodes_freed) * sizeof(Node)));
+}
+
+bool skiplist_metrics_snapshot(SkipList* list, const char* impl, MetricsSink sink, void* ctx) {
+    char* text = NULL;
+    size_t len = 0;
+    FILE* out = open_memstream(&text, &len);
+    if (!out) return false;
+
+    OpMetrics ops;
+    if (instrument_op_metrics(&ops)) {
+        write_op_metrics(out, impl, &ops);
+    }
+
+    ContentionStats contention;
+    if (skiplist_contention_stats(&contention)) {
+        write_contention_metrics(out, impl, &contention);
+    }
+
+    LockProfile profile;
+    if (skiplist_lock_profile(&profile)) {
+        write_lock_metrics(out, impl, &profile);
+    }
+
+    write_memory_metrics(out, impl, list);
+
+    if (fclose(out) != 0) {
+        free(text);
+        return false;
+    }
+    sink(text, len, ctx);
+    free(text);
+    return true;
+}
+
+static void write_to_file(const char* text, size_t len, void* ctx) {
+    FILE* f = (FILE*)ctx;
+    fwrite(text, 1, len, f);
+}
+
+// Writes to <path>.tmp and renames, so a scraper (e.g. node_exporter's
+// textfile collector) never sees a half-written file
+bool skiplist_metrics_write_file(SkipList* list, const char* impl, const char* path) {
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE* f = fopen(tmp_path, "w");
+    if (!f) {
+        perror("Failed to open metrics file");
+        return false;
+    }
+    bool ok = skiplist_metrics_snapshot(list, impl, write_to_file, f);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
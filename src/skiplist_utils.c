@@ -1,8 +1,10 @@
 #include "skiplist_common.h"
+#include "skiplist_instrument.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
 #include <limits.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/time.h>
 
@@ -31,7 +33,12 @@ int random_level(void) {
 }
 
 Node* create_node(int key, int value, int level) {
-    Node* node = (Node*)malloc(sizeof(Node));
+    return create_node_extra(key, value, level, 0);
+}
+
+// Room for per-variant data after the node (coarse link widths)
+Node* create_node_extra(int key, int value, int level, size_t extra_bytes) {
+    Node* node = (Node*)malloc(sizeof(Node) + extra_bytes);
     if (!node) {
         fprintf(stderr, "Failed to allocate memory for node\n");
         exit(1);
@@ -47,10 +54,17 @@ Node* create_node(int key, int value, int level) {
         atomic_init(&node->next[i], NULL);
     }
     
-    omp_init_lock(&node->lock);
+    skiplock_init(&node->lock);
+    MEMORY_INC(nodes_allocated);
     return node;
 }
 
+void free_node(Node* node) {
+    skiplock_destroy(&node->lock);
+    free(node);
+    MEMORY_INC(nodes_freed);
+}
+
 void print_skiplist(SkipList* list) {
     printf("\n=== Skip List Structure ===\n");
     for (int level = list->maxLevel; level >= 0; level--) {
@@ -88,4 +102,533 @@ bool validate_skiplist(SkipList* list) {
         }
     }
     return true;
-}
\ No newline at end of file
+}
+
+// A node is logically deleted if the fine-grained flag is set or the
+// lock-free level-0 pointer is marked (coarse unlinks immediately).
+static bool is_logically_deleted(Node* node) {
+    return atomic_load(&node->marked) || IS_MARKED(atomic_load(&node->next[0]));
+}
+
+// Replays the descent for `key` and counts the nodes visited per level.
+// Read-only, so safe against concurrent fine/lock-free updates (deleted
+// nodes are never freed there), but not against coarse deletes.
+static int search_hops(SkipList* list, int key, int* hops_per_level) {
+    Node* pred = list->head;
+    int total = 0;
+    
+    for (int level = list->maxLevel; level >= 0; level--) {
+        int hops = 1;
+        Node* curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        while (curr != list->tail && curr->key < key) {
+            pred = curr;
+            curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+            hops++;
+        }
+        if (hops_per_level) hops_per_level[level] += hops;
+        total += hops;
+    }
+    return total;
+}
+
+// Upper bound on simulated searches so stats stay cheap on huge lists
+#define STATS_MAX_PATH_SAMPLES 100000
+
+void skiplist_stats(SkipList* list, SkipListStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    
+    int reachable = 0;
+    for (int level = 0; level <= list->maxLevel; level++) {
+        Node* curr = GET_UNMARKED(atomic_load(&list->head->next[level]));
+        while (curr != list->tail) {
+            stats->nodes_per_level[level]++;
+            if (level == 0) {
+                if (is_logically_deleted(curr)) {
+                    stats->marked_linked++;
+                } else {
+                    stats->keys++;
+                }
+            }
+            curr = GET_UNMARKED(atomic_load(&curr->next[level]));
+        }
+    }
+    reachable = stats->nodes_per_level[0];
+    
+    // Search path lengths for (a stride of) the live keys
+    int stride = stats->keys / STATS_MAX_PATH_SAMPLES + 1;
+    int hops[MAX_LEVEL + 1] = {0};
+    long long total_hops = 0;
+    int index = 0;
+    
+    Node* curr = GET_UNMARKED(atomic_load(&list->head->next[0]));
+    while (curr != list->tail) {
+        if (!is_logically_deleted(curr) && index++ % stride == 0) {
+            int path = search_hops(list, curr->key, hops);
+            total_hops += path;
+            if (path > stats->max_path_length) stats->max_path_length = path;
+            stats->path_samples++;
+        }
+        curr = GET_UNMARKED(atomic_load(&curr->next[0]));
+    }
+    
+    if (stats->path_samples > 0) {
+        stats->avg_path_length = (double)total_hops / stats->path_samples;
+        for (int level = 0; level <= list->maxLevel; level++) {
+            stats->avg_hops_per_level[level] = (double)hops[level] / stats->path_samples;
+        }
+    }
+    
+    stats->node_bytes = (size_t)reachable * sizeof(Node);
+    stats->bytes_per_key = stats->keys > 0 ? (double)stats->node_bytes / stats->keys : 0.0;
+}
+
+void print_skiplist_stats(SkipListStats* stats) {
+    printf("=== Skip List Structure ===\n");
+    printf("Live keys:           %d\n", stats->keys);
+    printf("Marked but linked:   %d\n", stats->marked_linked);
+    printf("Level  Nodes      Avg hops\n");
+    for (int level = 0; level <= MAX_LEVEL; level++) {
+        if (stats->nodes_per_level[level] == 0 && stats->avg_hops_per_level[level] <= 1.0) continue;
+        printf("%5d  %-10d %.2f\n", level, stats->nodes_per_level[level],
+               stats->avg_hops_per_level[level]);
+    }
+    printf("Search path:         avg %.2f, max %d nodes (%d samples)\n",
+           stats->avg_path_length, stats->max_path_length, stats->path_samples);
+    printf("Node memory:         %zu bytes (%.1f bytes/key)\n",
+           stats->node_bytes, stats->bytes_per_key);
+    printf("===========================\n\n");
+}
+
+// Average nodes visited per search for random keys in [0, key_range)
+double skiplist_sample_hops(SkipList* list, int samples, int key_range, unsigned int seed) {
+    if (samples <= 0 || key_range <= 0) return 0.0;
+    
+    long long total = 0;
+    for (int i = 0; i < samples; i++) {
+        total += search_hops(list, rand_r(&seed) % key_range, NULL);
+    }
+    return (double)total / samples;
+}
+
+// ------------------------------------------------------------------------
+// Approximate order statistics for the fine and lock-free variants.
+//
+// A sample walks level 0 once and records the rank of every live node
+// whose tower reaches sample->level, picked so that about max_samples
+// nodes are kept. A query binary-searches the sample for the closest node
+// before the target and descends only the levels below it from there,
+// counting each step on level l as (1/P_FACTOR)^l keys, so the error is
+// about 2^level keys plus whatever changed since the sample was taken.
+// Sampled nodes are dereferenced later, so coarse lists (which free on
+// delete) must not change between the sample and the query.
+// ------------------------------------------------------------------------
+bool skiplist_rank_sample(SkipList* list, RankSample* sample, int max_samples) {
+    memset(sample, 0, sizeof(*sample));
+    if (max_samples < 1) max_samples = 1;
+    
+    double expected = atomic_load(&list->size);
+    while (sample->level < list->maxLevel && expected > max_samples) {
+        expected *= P_FACTOR;
+        sample->level++;
+    }
+    
+    int capacity = 0;
+    int rank = 0;
+    for (Node* curr = GET_UNMARKED(atomic_load(&list->head->next[0])); curr != list->tail;
+         curr = GET_UNMARKED(atomic_load(&curr->next[0]))) {
+        if (is_logically_deleted(curr)) continue;
+        if (curr->topLevel >= sample->level) {
+            if (sample->count == capacity) {
+                capacity = capacity ? 2 * capacity : 64;
+                Node** nodes = realloc(sample->nodes, capacity * sizeof(Node*));
+                int* ranks = realloc(sample->ranks, capacity * sizeof(int));
+                if (nodes) sample->nodes = nodes;
+                if (ranks) sample->ranks = ranks;
+                if (!nodes || !ranks) {
+                    free_rank_sample(sample);
+                    return false;
+                }
+            }
+            sample->nodes[sample->count] = curr;
+            sample->ranks[sample->count] = rank;
+            sample->count++;
+        }
+        rank++;
+    }
+    sample->size = rank;
+    return true;
+}
+
+void free_rank_sample(RankSample* sample) {
+    free(sample->nodes);
+    free(sample->ranks);
+    memset(sample, 0, sizeof(*sample));
+}
+
+// Expected level-0 links spanned by one step on the highest level below
+// the sample level
+static double below_sample_span(RankSample* sample) {
+    double span = 1.0;
+    for (int level = 1; level < sample->level; level++) {
+        span /= P_FACTOR;
+    }
+    return span;
+}
+
+int skiplist_rank_estimate(SkipList* list, RankSample* sample, int key) {
+    // Last sampled node below key; head stands at rank -1
+    int lo = 0, hi = sample->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (sample->nodes[mid]->key < key) lo = mid + 1;
+        else hi = mid;
+    }
+    Node* pred = lo > 0 ? sample->nodes[lo - 1] : list->head;
+    double rank = lo > 0 ? sample->ranks[lo - 1] : -1;
+    double span = below_sample_span(sample);
+    
+    for (int level = sample->level - 1; level >= 0; level--, span *= P_FACTOR) {
+        Node* curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        while (curr != list->tail && curr->key < key) {
+            rank += span;
+            pred = curr;
+            curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        }
+    }
+    return (int)(rank + 1);
+}
+
+bool skiplist_select_estimate(SkipList* list, RankSample* sample, int k, int* key) {
+    if (k < 0 || k >= sample->size) return false;
+    
+    // Last sampled node at or before rank k
+    int lo = 0, hi = sample->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (sample->ranks[mid] <= k) lo = mid + 1;
+        else hi = mid;
+    }
+    Node* pred = lo > 0 ? sample->nodes[lo - 1] : list->head;
+    double pos = lo > 0 ? sample->ranks[lo - 1] : -1;
+    double span = below_sample_span(sample);
+    
+    for (int level = sample->level - 1; level >= 0; level--, span *= P_FACTOR) {
+        Node* curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        while (curr != list->tail && pos + span <= k) {
+            pos += span;
+            pred = curr;
+            curr = GET_UNMARKED(atomic_load(&pred->next[level]));
+        }
+    }
+    
+    // Land on a live node: the first one when the descent never left head
+    while (pred == list->head || is_logically_deleted(pred)) {
+        pred = GET_UNMARKED(atomic_load(&pred->next[0]));
+        if (pred == list->tail) return false;
+    }
+    *key = pred->key;
+    return true;
+}
+
+// ------------------------------------------------------------------------
+// Parallel validation. Requires a quiescent list.
+//
+// The levels above split_level are small and are checked serially. The
+// live nodes at split_level then cut every lower level into segments
+// [start, end). Each segment is checked by one thread, walking from start
+// at every level up to split_level, since start is linked at all of them.
+// Each segment gets these checks:
+//   - key order and node heights at levels 0..split_level-1
+//   - tower consistency, merging level i against level i-1 for i in
+//     1..split_level
+// If a walk passes `end` by key, it scans on to tell whether the keys are
+// out of order or end is missing from that level.
+// ------------------------------------------------------------------------
+#define VALIDATE_PARTITIONS_PER_THREAD 8
+
+#define NEXT(node, level) GET_UNMARKED(atomic_load(&(node)->next[level]))
+
+// Order and height checks on `level` strictly between start and end
+static void check_level(SkipList* list, Node* start, Node* end, int level,
+                        ValidationReport* report) {
+    int prev_key = start == list->head ? INT_MIN : start->key;
+    bool prev_live = start != list->head && !is_logically_deleted(start);
+    Node* curr = NEXT(start, level);
+    
+    while (curr != end) {
+        if (curr == list->tail || (end != list->tail && curr->key > end->key)) {
+            // Passed end: either it comes later (out of order) or it is
+            // missing from this level although it is linked above
+            while (curr != list->tail && curr != end) {
+                curr = NEXT(curr, level);
+            }
+            if (curr == end) report->order_errors++;
+            else report->tower_errors++;
+            return;
+        }
+        bool live = !is_logically_deleted(curr);
+        report->nodes_per_level[level]++;
+        if (level == 0) {
+            if (live) report->keys++;
+            else report->marked_linked++;
+        }
+        if (curr->key < prev_key || (curr->key == prev_key && live && prev_live)) {
+            report->order_errors++;
+        }
+        if (curr->topLevel < level) {
+            report->height_errors++;
+        }
+        prev_key = curr->key;
+        prev_live = live;
+        curr = NEXT(curr, level);
+    }
+    if (end != list->tail && prev_key == end->key && prev_live && !is_logically_deleted(end)) {
+        report->order_errors++;
+    }
+}
+
+// Every live node on `level` between start and end must also be linked on
+// level - 1. Deleted nodes may already be unlinked below, so they are skipped.
+static void check_tower(SkipList* list, Node* start, Node* end, int level,
+                        ValidationReport* report) {
+    Node* lower = NEXT(start, level - 1);
+    
+    for (Node* upper = NEXT(start, level); upper != end && upper != list->tail;
+         upper = NEXT(upper, level)) {
+        while (lower != end && lower != list->tail && lower->key < upper->key) {
+            lower = NEXT(lower, level - 1);
+        }
+        // A deleted and a live node may share a key; look through the run
+        Node* match = lower;
+        while (match != end && match != list->tail && match->key == upper->key && match != upper) {
+            match = NEXT(match, level - 1);
+        }
+        if (match == upper) {
+            lower = match;
+        } else if (!is_logically_deleted(upper)) {
+            report->tower_errors++;
+        }
+    }
+}
+
+static void merge_report(ValidationReport* into, ValidationReport* from) {
+    for (int level = 0; level <= MAX_LEVEL; level++) {
+        into->nodes_per_level[level] += from->nodes_per_level[level];
+    }
+    into->keys += from->keys;
+    into->marked_linked += from->marked_linked;
+    into->order_errors += from->order_errors;
+    into->tower_errors += from->tower_errors;
+    into->height_errors += from->height_errors;
+}
+
+bool validate_skiplist_parallel(SkipList* list, int threads, ValidationReport* report) {
+    double start_time = omp_get_wtime();
+    memset(report, 0, sizeof(*report));
+    if (threads < 1) threads = 1;
+    report->threads = threads;
+    
+    // Serial part: top levels down to the first one with enough nodes
+    int target = threads > 1 ? threads * VALIDATE_PARTITIONS_PER_THREAD : INT_MAX;
+    int split = 0;
+    for (int level = list->maxLevel; level >= 0; level--) {
+        check_level(list, list->head, list->tail, level, report);
+        if (level < list->maxLevel) {
+            check_tower(list, list->head, list->tail, level + 1, report);
+        }
+        if (level > 0 && report->nodes_per_level[level] >= target) {
+            split = level;
+            break;
+        }
+    }
+    report->split_level = split;
+    
+    if (split > 0) {
+        // Segment boundaries: head, then the live nodes at the split level
+        Node** bounds = malloc((report->nodes_per_level[split] + 2) * sizeof(Node*));
+        if (!bounds) {
+            fprintf(stderr, "Failed to allocate validation partitions\n");
+            exit(1);
+        }
+        int count = 0;
+        bounds[count++] = list->head;
+        for (Node* curr = NEXT(list->head, split); curr != list->tail; curr = NEXT(curr, split)) {
+            if (!is_logically_deleted(curr)) bounds[count++] = curr;
+        }
+        bounds[count] = list->tail;
+        report->partitions = count;
+        
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+        for (int i = 0; i < count; i++) {
+            ValidationReport local;
+            memset(&local, 0, sizeof(local));
+            Node* start = bounds[i];
+            Node* end = bounds[i + 1];
+            
+            // The boundary node itself, on the levels below the split
+            if (start != list->head) {
+                for (int level = 0; level < split; level++) {
+                    local.nodes_per_level[level]++;
+                }
+                local.keys++;
+            }
+            for (int level = 0; level < split; level++) {
+                check_level(list, start, end, level, &local);
+            }
+            for (int level = split; level >= 1; level--) {
+                check_tower(list, start, end, level, &local);
+            }
+            
+            #pragma omp critical(validate_merge)
+            merge_report(report, &local);
+        }
+        free(bounds);
+    } else {
+        report->partitions = 1;
+    }
+    
+    report->size = atomic_load(&list->size);
+    report->seconds = omp_get_wtime() - start_time;
+    
+    return report->order_errors == 0 && report->tower_errors == 0 &&
+           report->height_errors == 0 && report->keys == report->size;
+}
+
+void print_validation_report(ValidationReport* report) {
+    bool valid = report->order_errors == 0 && report->tower_errors == 0 &&
+                 report->height_errors == 0 && report->keys == report->size;
+    printf("=== Skip List Validation ===\n");
+    printf("Result:              %s\n", valid ? "ok" : "FAILED");
+    printf("Live keys:           %d (size counter %d)\n", report->keys, report->size);
+    printf("Marked but linked:   %d\n", report->marked_linked);
+    printf("Order errors:        %d\n", report->order_errors);
+    printf("Tower errors:        %d\n", report->tower_errors);
+    printf("Height errors:       %d\n", report->height_errors);
+    printf("Level  Nodes\n");
+    for (int level = 0; level <= MAX_LEVEL; level++) {
+        if (report->nodes_per_level[level] == 0) continue;
+        printf("%5d  %d\n", level, report->nodes_per_level[level]);
+    }
+    printf("Partitions:          %d at level %d, %d threads, %.3f s\n",
+           report->partitions, report->split_level, report->threads, report->seconds);
+    printf("============================\n\n");
+}
+
+// Below this many keys a parallel region costs more than it saves
+#define PARALLEL_FREE_MIN_KEYS 65536
+#define FREE_PARTITIONS_PER_THREAD 8
+
+static void free_chain(Node* start, Node* end) {
+    Node* curr = start;
+    while (curr != end) {
+        Node* next = GET_UNMARKED(atomic_load(&curr->next[0]));
+        free_node(curr);
+        curr = next;
+    }
+}
+
+// Frees every node linked at level 0, sentinels included. Large lists are
+// split at the nodes of the highest level with enough of them, and each
+// segment's level-0 chain is freed by one thread. Only live tower nodes
+// bound segments: a deleted one may be gone from level 0 already. The list
+// must be quiescent. Nodes already unlinked (retired) are not reachable here.
+void free_all_nodes(SkipList* list) {
+    int threads = omp_get_max_threads();
+    if (threads < 2 || omp_in_parallel() || atomic_load(&list->size) < PARALLEL_FREE_MIN_KEYS) {
+        free_chain(list->head, NULL);
+        return;
+    }
+    
+    int target = threads * FREE_PARTITIONS_PER_THREAD;
+    int level = list->maxLevel;
+    int count = 0;
+    for (; level > 0; level--) {
+        count = 0;
+        for (Node* curr = GET_UNMARKED(atomic_load(&list->head->next[level])); curr != list->tail;
+             curr = GET_UNMARKED(atomic_load(&curr->next[level]))) {
+            count++;
+        }
+        if (count >= target) break;
+    }
+    if (level == 0) {
+        free_chain(list->head, NULL);
+        return;
+    }
+    
+    // Segments start at head and at each tower node; the last one ends
+    // after the tail. All bounds are read before any node is freed.
+    Node** bounds = malloc((count + 2) * sizeof(Node*));
+    if (!bounds) {
+        free_chain(list->head, NULL);
+        return;
+    }
+    int segments = 0;
+    bounds[segments++] = list->head;
+    for (Node* curr = GET_UNMARKED(atomic_load(&list->head->next[level])); curr != list->tail;
+         curr = GET_UNMARKED(atomic_load(&curr->next[level]))) {
+        if (!is_logically_deleted(curr)) bounds[segments++] = curr;
+    }
+    bounds[segments] = NULL;
+    
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+    for (int i = 0; i < segments; i++) {
+        free_chain(bounds[i], bounds[i + 1]);
+    }
+    free(bounds);
+}
+
+// ------------------------------------------------------------------------
+// Split and join. Only the links that cross the cut change: one per level.
+// The suffix keeps the tail sentinel its last nodes already point to, and
+// the prefix gets the fresh list's tail instead. Both lists must be
+// quiescent; the coarse variant holds its lock.
+// ------------------------------------------------------------------------
+
+// Live nodes from `first` up to the tail. Walks the kept and the moved part
+// side by side, so the cost is the smaller of the two.
+static int count_moved(SkipList* list, Node* first) {
+    Node* kept = GET_UNMARKED(atomic_load(&list->head->next[0]));
+    Node* moved = first;
+    int kept_live = 0, moved_live = 0;
+    
+    while (true) {
+        if (kept == first) return atomic_load(&list->size) - kept_live;
+        if (moved == list->tail) return moved_live;
+        if (!is_logically_deleted(kept)) kept_live++;
+        if (!is_logically_deleted(moved)) moved_live++;
+        kept = GET_UNMARKED(atomic_load(&kept->next[0]));
+        moved = GET_UNMARKED(atomic_load(&moved->next[0]));
+    }
+}
+
+void split_at_preds(SkipList* list, SkipList* into, Node** preds, int moved) {
+    if (moved < 0) moved = count_moved(list, GET_UNMARKED(atomic_load(&preds[0]->next[0])));
+    
+    Node* tail = into->tail;
+    into->tail = list->tail;
+    list->tail = tail;
+    for (int level = 0; level <= list->maxLevel; level++) {
+        atomic_store(&into->head->next[level], GET_UNMARKED(atomic_load(&preds[level]->next[level])));
+        atomic_store(&preds[level]->next[level], tail);
+    }
+    
+    atomic_store(&into->size, moved);
+    atomic_fetch_sub(&list->size, moved);
+}
+
+bool join_at_lasts(SkipList* list, SkipList* other, Node** lasts) {
+    Node* first = GET_UNMARKED(atomic_load(&other->head->next[0]));
+    if (lasts[0] != list->head && first != other->tail && lasts[0]->key >= first->key) {
+        return false;
+    }
+    
+    for (int level = 0; level <= list->maxLevel; level++) {
+        atomic_store(&lasts[level]->next[level], GET_UNMARKED(atomic_load(&other->head->next[level])));
+    }
+    free_node(list->tail);
+    free_node(other->head);
+    list->tail = other->tail;
+    atomic_fetch_add(&list->size, atomic_load(&other->size));
+    free(other);
+    return true;
+}
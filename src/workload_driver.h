@@ -0,0 +1,99 @@
+/**
+ * Benchmark Workload Driver Template
+ *
+ * Deliberately has no include guard. benchmark.c includes it once per
+ * implementation, with these macros naming the driver and its operations:
+ *
+ *     #define DRIVER_NAME     run_workload_coarse
+ *     #define DRIVER_INSERT   skiplist_insert_coarse
+ *     #define DRIVER_DELETE   skiplist_delete_coarse
+ *     #define DRIVER_CONTAINS skiplist_contains_coarse
+ *     #include "workload_driver.h"
+ *
+ * With plain function names the hot loop makes direct calls. The compiler
+ * can then inline them, which needs 'make lto' since the operations live in
+ * other translation units. With ops->insert and friends the same loop
+ * becomes the indirect (function pointer) driver.
+ * The macros are undefined at the end.
+ */
+
+#if !defined(DRIVER_NAME) || !defined(DRIVER_INSERT) || !defined(DRIVER_DELETE) || !defined(DRIVER_CONTAINS)
+#error "Define DRIVER_NAME, DRIVER_INSERT, DRIVER_DELETE and DRIVER_CONTAINS before including workload_driver.h"
+#endif
+
+static BenchmarkResult DRIVER_NAME(SkipList* list, SkipListOps* ops, BenchmarkConfig* config,
+                                   WorkloadMix group_mix[NUM_GROUPS]) {
+    (void)ops;  // Only used by the indirect driver
+    BenchmarkResult result = {0};
+    long long successful = 0;
+    long long completed = 0;
+    bool open_loop = config->rate > 0;
+    bool track_latency = config->per_thread || open_loop || reader_writer_mode(config);
+    double interval_ns = open_loop ? 1e9 / config->rate : 0.0;
+    
+    double start = omp_get_wtime();
+    uint64_t schedule_base = hist_now_ns();
+    
+    #pragma omp parallel num_threads(config->num_threads) reduction(+:successful, completed)
+    {
+        int tid = omp_get_thread_num();
+        WorkloadMix mix = group_mix[thread_group(config, tid)];
+        unsigned int seed = tid * mix.seed_base;
+        ThreadStats* ts = &thread_stats[tid];
+        long long thread_successful = 0;
+        // Stagger the threads' schedules so their arrivals interleave
+        uint64_t thread_base = schedule_base + (uint64_t)(interval_ns * tid / config->num_threads);
+        worker_begin();
+        
+        long i;
+        int key = 0;
+        for (i = 0; keep_running(config, i); i++) {
+            int op_type = mix.random_ops ? rand_r(&seed) % 100 : 0;
+            if (mix.scan_length > 0 && i % mix.scan_length != 0) {
+                key = key + 1 < config->key_range ? key + 1 : 0;
+            } else {
+                key = rand_r(&seed) % config->key_range;
+            }
+            uint64_t op_start = 0;
+            if (open_loop) {
+                // Latency counts from the intended start, so time spent queued
+                // behind a slow op is not omitted (no coordinated omission)
+                op_start = thread_base + (uint64_t)(i * interval_ns);
+                wait_until_ns(op_start);
+            } else if (track_latency) {
+                op_start = hist_now_ns();
+            }
+            bool ok;
+            
+            if (op_type < mix.insert_percent) {
+                ok = DRIVER_INSERT(list, key, key);
+            } else if (op_type < mix.insert_percent + mix.delete_percent) {
+                ok = DRIVER_DELETE(list, key);
+            } else {
+                ok = DRIVER_CONTAINS(list, key);
+            }
+            
+            if (ok) thread_successful++;
+            if (track_latency) hist_record(&ts->latency, hist_now_ns() - op_start);
+        }
+        worker_end();
+        finish_thread_stats(ts, i, thread_successful, start);
+        successful += thread_successful;
+        completed += i;
+    }
+    
+    double end = omp_get_wtime();
+    
+    result.total_time = end - start;
+    result.total_ops = completed;
+    result.successful_ops = successful;
+    result.failed_ops = completed - successful;
+    result.throughput = completed / result.total_time;
+    
+    return result;
+}
+
+#undef DRIVER_NAME
+#undef DRIVER_INSERT
+#undef DRIVER_DELETE
+#undef DRIVER_CONTAINS
@@ -1,6 +1,9 @@
 #include "../src/skiplist_common.h"
+#include "../src/baselines.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <assert.h>
 #include <omp.h>
 
@@ -15,6 +18,11 @@ typedef struct {
     bool (*delete)(SkipList*, int);
     bool (*contains)(SkipList*, int);
     void (*destroy)(SkipList*);
+    int (*delete_range)(SkipList*, int, int);  // Fine and lock-free only
+    int (*count_range)(SkipList*, int, int);
+    SkipList* (*split)(SkipList*, int);
+    bool (*join)(SkipList*, SkipList*);
+    bool baseline;  // AVL/hash/B+tree: no skip-list structure to inspect
 } SkipListOps;
 
 void test_basic(SkipListOps* ops) {
@@ -107,7 +115,430 @@ void test_mixed(SkipListOps* ops) {
         }
     }
     
-    assert(validate_skiplist(list));
+    if (!ops->baseline) {
+        assert(validate_skiplist(list));
+    }
+    int present = 0;
+    for (int key = 0; key < TEST_SIZE; key++) {
+        if (ops->contains(list, key)) present++;
+    }
+    assert(present == atomic_load(&list->size));
+    ops->destroy(list);
+}
+
+// Enough keys to resize the hash table and grow the B+tree several levels:
+// each thread inserts its own keys, deletes the odd ones, and looks up a
+// neighbour's keys meanwhile
+void test_churn(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int per_thread = TEST_SIZE * 10;
+    
+    #pragma omp parallel num_threads(NUM_THREADS)
+    {
+        int tid = omp_get_thread_num();
+        int neighbour = (tid + 1) % NUM_THREADS;
+        for (int i = 0; i < per_thread; i++) {
+            assert(ops->insert(list, i * NUM_THREADS + tid, 0));
+            ops->contains(list, i * NUM_THREADS + neighbour);
+        }
+        for (int i = 1; i < per_thread; i += 2) {
+            assert(ops->delete(list, i * NUM_THREADS + tid));
+            assert(!ops->insert(list, (i - 1) * NUM_THREADS + tid, 0));
+        }
+    }
+    
+    for (int key = 0; key < per_thread * NUM_THREADS; key++) {
+        assert(ops->contains(list, key) == ((key / NUM_THREADS) % 2 == 0));
+    }
+    assert(atomic_load(&list->size) == per_thread / 2 * NUM_THREADS);
+    ops->destroy(list);
+}
+
+void test_validate_parallel(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int range = TEST_SIZE * 40;
+    
+    #pragma omp parallel num_threads(NUM_THREADS)
+    {
+        unsigned int seed = omp_get_thread_num() + 1;
+        for (int i = 0; i < range; i++) {
+            int key = rand_r(&seed) % range;
+            if (rand_r(&seed) % 4 == 0) {
+                ops->delete(list, key);
+            } else {
+                ops->insert(list, key, key);
+            }
+        }
+    }
+    
+    ValidationReport report;
+    SkipListStats stats;
+    assert(validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.split_level > 0 && report.partitions > 1);
+    skiplist_stats(list, &stats);
+    assert(report.keys == stats.keys);
+    for (int level = 0; level <= MAX_LEVEL; level++) {
+        assert(report.nodes_per_level[level] == stats.nodes_per_level[level]);
+    }
+    
+    // Swapping two adjacent keys breaks the order at level 0
+    Node* a = GET_UNMARKED(atomic_load(&list->head->next[0]));
+    Node* b = GET_UNMARKED(atomic_load(&a->next[0]));
+    int key = a->key;
+    a->key = b->key;
+    b->key = key;
+    assert(!validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.order_errors > 0);
+    b->key = a->key;
+    a->key = key;
+    
+    // Unlinking a tall node from level 0 only breaks its tower
+    Node* pred = list->head;
+    Node* tall = GET_UNMARKED(atomic_load(&pred->next[0]));
+    while (tall->topLevel == 0) {
+        pred = tall;
+        tall = GET_UNMARKED(atomic_load(&tall->next[0]));
+    }
+    atomic_store(&pred->next[0], atomic_load(&tall->next[0]));
+    assert(!validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.tower_errors > 0);
+    atomic_store(&pred->next[0], tall);
+    assert(validate_skiplist_parallel(list, 1, &report));
+    
+    ops->destroy(list);
+}
+
+void test_teardown(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int range = 200000;  // Large enough for the parallel teardown path
+    
+    #pragma omp parallel for num_threads(NUM_THREADS)
+    for (int i = 0; i < range; i++) {
+        ops->insert(list, i, i);
+    }
+    #pragma omp parallel for num_threads(NUM_THREADS)
+    for (int i = 0; i < range; i += 3) {
+        ops->delete(list, i);
+    }
+    
+    SkipListStats stats;
+    MemoryStats before, after;
+    skiplist_stats(list, &stats);
+    skiplist_memory_stats(&before);
+    
+    int saved_threads = omp_get_max_threads();
+    omp_set_num_threads(NUM_THREADS);
+    ops->destroy(list);
+    omp_set_num_threads(saved_threads);
+    
+    // Every node still linked at level 0, plus head and tail, freed once
+    skiplist_memory_stats(&after);
+    assert(after.nodes_freed - before.nodes_freed == (uint64_t)stats.nodes_per_level[0] + 2);
+}
+
+// Lock-free only: concurrent pops return every key exactly once, in
+// increasing order per thread when nothing is inserted meanwhile, and never
+// skip a smaller key inserted ahead of the deleted prefix
+void test_pop_min(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int total = TEST_SIZE * NUM_THREADS;
+    int* popped = calloc(total, sizeof(int));
+    
+    for (int i = 0; i < total; i++) {
+        assert(ops->insert(list, i, -i));
+    }
+    
+    #pragma omp parallel num_threads(NUM_THREADS)
+    {
+        int key, value, last = -1;
+        while (skiplist_pop_min_lockfree(list, &key, &value)) {
+            assert(key > last && value == -key);
+            last = key;
+            __atomic_fetch_add(&popped[key], 1, __ATOMIC_RELAXED);
+        }
+    }
+    for (int i = 0; i < total; i++) {
+        assert(popped[i] == 1);
+    }
+    assert(atomic_load(&list->size) == 0);
+    
+    // Pops racing with inserts of disjoint keys, then drain the rest
+    memset(popped, 0, total * sizeof(int));
+    #pragma omp parallel num_threads(NUM_THREADS)
+    {
+        int tid = omp_get_thread_num();
+        int key, value;
+        for (int i = 0; i < TEST_SIZE; i++) {
+            assert(ops->insert(list, i * NUM_THREADS + tid, 0));
+            if (i % 2 == 1 && skiplist_pop_min_lockfree(list, &key, &value)) {
+                __atomic_fetch_add(&popped[key], 1, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    int key, value;
+    while (skiplist_pop_min_lockfree(list, &key, &value)) {
+        popped[key]++;
+    }
+    for (int i = 0; i < total; i++) {
+        assert(popped[i] == 1);
+    }
+    
+    // One thread inserts keys below the current minimum while another pops.
+    // A key published before a pop starts is still queued unless this
+    // popper took it, so the pop must not return anything larger.
+    int* seen = calloc(2 * total, sizeof(int));
+    for (int i = total; i < 2 * total; i++) {
+        assert(ops->insert(list, i, 0));
+    }
+    int lowest = total;
+    #pragma omp parallel num_threads(2)
+    {
+        if (omp_get_thread_num() == 0) {
+            for (int k = total - 1; k >= 0; k--) {
+                assert(ops->insert(list, k, 0));
+                __atomic_store_n(&lowest, k, __ATOMIC_RELEASE);
+            }
+        } else {
+            int key, value;
+            for (int n = 0; n < total; n++) {
+                int low = __atomic_load_n(&lowest, __ATOMIC_ACQUIRE);
+                assert(skiplist_pop_min_lockfree(list, &key, &value));
+                assert(key <= low || seen[low]);
+                seen[key]++;
+            }
+        }
+    }
+    while (skiplist_pop_min_lockfree(list, &key, &value)) {
+        seen[key]++;
+    }
+    for (int i = 0; i < 2 * total; i++) {
+        assert(seen[i] == 1);
+    }
+    
+    ValidationReport report;
+    assert(validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.keys == 0);
+    
+    free(seen);
+    free(popped);
+    ops->destroy(list);
+}
+
+// Lock-free only: sprays land near the front and still pop every key once
+void test_pop_approx_min(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int total = TEST_SIZE * 20;
+    int* popped = calloc(total, sizeof(int));
+    
+    for (int i = 0; i < total; i++) {
+        assert(ops->insert(list, i, i));
+    }
+    
+    // Sized for 8 threads, a spray walks at most 27 nodes on each of
+    // levels 4..0, so it lands well inside the first half
+    int key, value;
+    for (int i = 0; i < 100; i++) {
+        assert(skiplist_pop_approx_min_lockfree(list, 8, &key, &value));
+        assert(key < total / 2 && popped[key] == 0);
+        popped[key]++;
+    }
+    
+    #pragma omp parallel num_threads(NUM_THREADS)
+    {
+        int k, v;
+        while (skiplist_pop_approx_min_lockfree(list, NUM_THREADS, &k, &v)) {
+            __atomic_fetch_add(&popped[k], 1, __ATOMIC_RELAXED);
+        }
+    }
+    for (int i = 0; i < total; i++) {
+        assert(popped[i] == 1);
+    }
+    
+    ValidationReport report;
+    assert(validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.keys == 0);
+    
+    free(popped);
+    ops->destroy(list);
+}
+
+// Indexable coarse only: exact rank/select after shuffled inserts and deletes
+void test_rank_select(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int total = TEST_SIZE * NUM_THREADS;
+    
+    // Keys 0, 2, ..., 2 * (total - 1) from several threads, then drop
+    // every third one
+    #pragma omp parallel for num_threads(NUM_THREADS)
+    for (int i = 0; i < total; i++) {
+        int key = 2 * ((i * 7919) % total);
+        assert(ops->insert(list, key, key));
+    }
+    for (int i = 0; i < total; i += 3) {
+        assert(ops->delete(list, 2 * i));
+    }
+    
+    int* expected = malloc(total * sizeof(int));
+    int live = 0;
+    for (int i = 0; i < total; i++) {
+        if (i % 3 != 0) expected[live++] = 2 * i;
+    }
+    assert(atomic_load(&list->size) == live);
+    
+    int key;
+    for (int k = 0; k < live; k++) {
+        assert(skiplist_select_coarse(list, k, &key) && key == expected[k]);
+        assert(skiplist_rank_coarse(list, expected[k]) == k);
+        assert(skiplist_rank_coarse(list, expected[k] + 1) == k + 1);
+    }
+    assert(!skiplist_select_coarse(list, live, &key));
+    assert(!skiplist_select_coarse(list, -1, &key));
+    assert(skiplist_rank_coarse(list, -1) == 0);
+    
+    free(expected);
+    ops->destroy(list);
+}
+
+// Lock-free only: sampled estimates stay close to the true rank, and are
+// exact when every node fits in the sample
+void test_rank_estimate(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int total = TEST_SIZE * 20;
+    
+    for (int i = 0; i < total; i++) {
+        assert(ops->insert(list, 2 * i, i));
+    }
+    
+    RankSample sample;
+    int key;
+    assert(skiplist_rank_sample(list, &sample, total));
+    assert(sample.level == 0 && sample.count == total && sample.size == total);
+    for (int k = 0; k < total; k += 7) {
+        assert(skiplist_rank_estimate(list, &sample, 2 * k + 1) == k + 1);
+        assert(skiplist_select_estimate(list, &sample, k, &key) && key == 2 * k);
+    }
+    free_rank_sample(&sample);
+    
+    // A coarse sample: off by a few 2^level at most
+    assert(skiplist_rank_sample(list, &sample, 64));
+    int tolerance = 8 << sample.level;
+    for (int k = 0; k < total; k += 7) {
+        assert(abs(skiplist_rank_estimate(list, &sample, 2 * k + 1) - (k + 1)) <= tolerance);
+        assert(skiplist_select_estimate(list, &sample, k, &key));
+        assert(abs(key / 2 - k) <= tolerance);
+    }
+    assert(!skiplist_select_estimate(list, &sample, total, &key));
+    free_rank_sample(&sample);
+    
+    ops->destroy(list);
+}
+
+// Fine and lock-free: range deletes remove each key exactly once, also when
+// they overlap each other and race with inserts outside the ranges
+void test_range(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int total = TEST_SIZE * NUM_THREADS;
+    
+    for (int i = 0; i < total; i++) {
+        assert(ops->insert(list, i, i));
+    }
+    assert(ops->count_range(list, 100, 200) == 100);
+    assert(ops->delete_range(list, 100, 200) == 100);
+    assert(ops->count_range(list, 100, 200) == 0);
+    assert(ops->delete_range(list, 100, 200) == 0);
+    assert(ops->delete_range(list, 300, 300) == 0);
+    assert(ops->contains(list, 99) && !ops->contains(list, 100));
+    assert(!ops->contains(list, 199) && ops->contains(list, 200));
+    assert(ops->count_range(list, 0, total) == total - 100);
+    assert(atomic_load(&list->size) == total - 100);
+    
+    // Thread t drops [t * step, (t + 2) * step) and inserts keys past total
+    int step = total / (NUM_THREADS + 1);
+    int deleted = 0;
+    #pragma omp parallel num_threads(NUM_THREADS) reduction(+:deleted)
+    {
+        int tid = omp_get_thread_num();
+        for (int i = 0; i < TEST_SIZE; i++) {
+            assert(ops->insert(list, total + i * NUM_THREADS + tid, 0));
+            if (i % 100 == 0) {
+                deleted += ops->delete_range(list, tid * step, (tid + 2) * step);
+            }
+        }
+    }
+    int end = (NUM_THREADS + 1) * step;
+    assert(deleted == end - 100);
+    assert(ops->count_range(list, 0, end) == 0);
+    assert(ops->count_range(list, INT_MIN, INT_MAX) == 2 * total - end);
+    
+    ValidationReport report;
+    assert(validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.keys == 2 * total - end && report.marked_linked == 0);
+    
+    ops->destroy(list);
+}
+
+// Every live key of `list` is in [from, to) and the structure is sound;
+// indexable lists also answer select from their widths
+static void check_part(SkipListOps* ops, SkipList* list, int from, int to) {
+    ValidationReport report;
+    assert(validate_skiplist_parallel(list, NUM_THREADS, &report));
+    assert(report.keys == atomic_load(&list->size));
+    
+    int live = 0;
+    for (int key = from; key < to; key++) {
+        if (key % 5 != 0) {
+            assert(ops->contains(list, key));
+            if (list->indexable) {
+                int found;
+                assert(skiplist_select_coarse(list, live, &found) && found == key);
+            }
+            live++;
+        }
+    }
+    assert(report.keys == live);
+}
+
+void test_split_join(SkipListOps* ops) {
+    SkipList* list = ops->create();
+    int total = TEST_SIZE * NUM_THREADS;
+    
+    // Keys 0..total-1 without multiples of 5
+    #pragma omp parallel for num_threads(NUM_THREADS)
+    for (int i = 0; i < total; i++) {
+        assert(ops->insert(list, i, i));
+    }
+    for (int i = 0; i < total; i += 5) {
+        assert(ops->delete(list, i));
+    }
+    
+    int cut = total / 3 + 1;
+    SkipList* right = ops->split(list, cut);
+    check_part(ops, list, 0, cut);
+    check_part(ops, right, cut, total);
+    assert(!ops->contains(list, cut + 1) && !ops->contains(right, cut - 1));
+    
+    // Empty sides, and overlapping keys refuse to join
+    SkipList* none = ops->split(right, total);
+    SkipList* all = ops->split(none, INT_MIN);
+    assert(atomic_load(&none->size) == 0 && atomic_load(&all->size) == 0);
+    assert(!ops->join(none, none));
+    assert(ops->join(none, all));
+    assert(!ops->join(right, list));
+    check_part(ops, right, cut, total);
+    
+    // Both halves keep working independently, then join back
+    #pragma omp parallel sections num_threads(2)
+    {
+        #pragma omp section
+        assert(ops->insert(list, -5, 0) && ops->delete(list, -5));
+        #pragma omp section
+        assert(ops->insert(right, total + 5, 0) && ops->delete(right, total + 5));
+    }
+    assert(ops->join(list, right));
+    assert(ops->join(list, none));
+    check_part(ops, list, 0, total);
+    assert(ops->insert(list, total, 0) && ops->insert(list, -1, 0));
+    
     ops->destroy(list);
 }
 
@@ -125,6 +556,11 @@ void run_tests(const char* name, SkipListOps* ops) {
     RUN_TEST(sequential, ops);
     RUN_TEST(concurrent, ops);
     RUN_TEST(mixed, ops);
+    RUN_TEST(churn, ops);
+    if (ops->baseline) return;
+    RUN_TEST(validate_parallel, ops);
+    RUN_TEST(teardown, ops);
+    RUN_TEST(split_join, ops);
 }
 
 int main(void) {
@@ -136,27 +572,94 @@ int main(void) {
         skiplist_insert_coarse,
         skiplist_delete_coarse,
         skiplist_contains_coarse,
-        skiplist_destroy_coarse
+        skiplist_destroy_coarse,
+        NULL,
+        NULL,
+        skiplist_split_coarse,
+        skiplist_join_coarse,
+        false
     };
     run_tests("Coarse-Grained", &coarse_ops);
     
+    SkipListOps indexable_ops = coarse_ops;
+    indexable_ops.create = skiplist_create_coarse_indexable;
+    run_tests("Coarse-Grained (Indexable)", &indexable_ops);
+    RUN_TEST(rank_select, &indexable_ops);
+    
     SkipListOps fine_ops = {
         skiplist_create_fine,
         skiplist_insert_fine,
         skiplist_delete_fine,
         skiplist_contains_fine,
-        skiplist_destroy_fine
+        skiplist_destroy_fine,
+        skiplist_delete_range_fine,
+        skiplist_count_range_fine,
+        skiplist_split_fine,
+        skiplist_join_fine,
+        false
     };
     run_tests("Fine-Grained", &fine_ops);
+    RUN_TEST(range, &fine_ops);
+    
+    // The coarse and fine suites again under the other lock policies
+    skiplock_set_policy(LOCK_POLICY_SPIN);
+    run_tests("Coarse-Grained (spin lock)", &coarse_ops);
+    run_tests("Fine-Grained (spin lock)", &fine_ops);
+    skiplock_set_policy(LOCK_POLICY_OMP);
+    run_tests("Coarse-Grained (omp lock)", &coarse_ops);
+    run_tests("Fine-Grained (omp lock)", &fine_ops);
+    skiplock_set_policy(LOCK_POLICY_PARK);
     
     SkipListOps lockfree_ops = {
         skiplist_create_lockfree,
         skiplist_insert_lockfree,
         skiplist_delete_lockfree,
         skiplist_contains_lockfree,
-        skiplist_destroy_lockfree
+        skiplist_destroy_lockfree,
+        skiplist_delete_range_lockfree,
+        skiplist_count_range_lockfree,
+        skiplist_split_lockfree,
+        skiplist_join_lockfree,
+        false
     };
     run_tests("Lock-Free", &lockfree_ops);
+    RUN_TEST(range, &lockfree_ops);
+    RUN_TEST(pop_min, &lockfree_ops);
+    RUN_TEST(pop_approx_min, &lockfree_ops);
+    RUN_TEST(rank_estimate, &lockfree_ops);
+    
+    SkipListOps avl_ops = {
+        baseline_create_avl,
+        baseline_insert_avl,
+        baseline_delete_avl,
+        baseline_contains_avl,
+        baseline_destroy_avl,
+        NULL, NULL, NULL, NULL,
+        true
+    };
+    run_tests("AVL Baseline", &avl_ops);
+    
+    SkipListOps hash_ops = {
+        baseline_create_hash,
+        baseline_insert_hash,
+        baseline_delete_hash,
+        baseline_contains_hash,
+        baseline_destroy_hash,
+        NULL, NULL, NULL, NULL,
+        true
+    };
+    run_tests("Striped Hash Baseline", &hash_ops);
+    
+    SkipListOps btree_ops = {
+        baseline_create_btree,
+        baseline_insert_btree,
+        baseline_delete_btree,
+        baseline_contains_btree,
+        baseline_destroy_btree,
+        NULL, NULL, NULL, NULL,
+        true
+    };
+    run_tests("B+Tree Baseline", &btree_ops);
     
     printf("\n============================\n");
     printf("All %d tests PASSED ✓\n", tests_passed);
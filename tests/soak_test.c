@@ -0,0 +1,365 @@
+#include "../src/skiplist_common.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <omp.h>
+
+/**
+ * Soak Test
+ *
+ * Runs a mixed workload on one list for --duration seconds, split into
+ * epochs of --interval seconds. Between epochs the workers are joined and,
+ * with the list quiescent, the test:
+ *   - runs validate_skiplist_parallel(), which also checks the towers and
+ *     that the size counter matches the live keys at level 0
+ *   - records throughput, RSS, node memory, live/retired nodes and the
+ *     average search path
+ * At the end the last epochs are compared with the first ones (after a
+ * warm-up epoch). The test fails if throughput dropped, or the search
+ * path or non-node RSS grew, by more than the configured percentages.
+ * Non-node RSS is RSS minus the malloc footprint of every node not yet
+ * freed. Retired nodes are never freed by the fine and lock-free variants,
+ * so their growth is reported but only fails the test with --max-rss-mb.
+ */
+
+#define TREND_WINDOW 3   // Epochs averaged at the start and at the end
+#define MAX_EPOCHS 100000
+
+// glibc chunk size of one node: payload plus size header, 16-byte aligned
+#define NODE_FOOTPRINT ((sizeof(Node) + sizeof(size_t) + 15) & ~(size_t)15)
+
+typedef struct {
+    SkipList* (*create)(void);
+    bool (*insert)(SkipList*, int, int);
+    bool (*delete)(SkipList*, int);
+    bool (*contains)(SkipList*, int);
+    void (*destroy)(SkipList*);
+} SkipListOps;
+
+typedef struct {
+    char impl[20];
+    double duration;
+    double interval;
+    int threads;
+    int key_range;
+    int insert_percent;
+    int delete_percent;
+    double rate;                 // Ops/sec per thread, 0 = unthrottled
+    double max_throughput_drift; // Percent
+    double max_path_drift;       // Percent
+    double max_rss_drift;        // Percent of the reference RSS
+    double max_rss_mb;           // Absolute cap, 0 = off
+    const char* trend_path;
+} SoakConfig;
+
+typedef struct {
+    double elapsed;
+    long long ops;
+    double throughput;
+    long rss_kb;
+    double node_mb;              // Footprint of allocated, unfreed nodes
+    double other_rss_mb;         // RSS not explained by nodes
+    int live;
+    long long retired;
+    double avg_path;
+    bool valid;
+} Epoch;
+
+static Epoch epochs[MAX_EPOCHS];
+
+static bool get_ops(const char* impl, SkipListOps* ops) {
+    if (strcmp(impl, "coarse") == 0) {
+        *ops = (SkipListOps){ skiplist_create_coarse, skiplist_insert_coarse, skiplist_delete_coarse,
+                              skiplist_contains_coarse, skiplist_destroy_coarse };
+    } else if (strcmp(impl, "fine") == 0) {
+        *ops = (SkipListOps){ skiplist_create_fine, skiplist_insert_fine, skiplist_delete_fine,
+                              skiplist_contains_fine, skiplist_destroy_fine };
+    } else if (strcmp(impl, "lockfree") == 0) {
+        *ops = (SkipListOps){ skiplist_create_lockfree, skiplist_insert_lockfree, skiplist_delete_lockfree,
+                              skiplist_contains_lockfree, skiplist_destroy_lockfree };
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static long current_rss_kb(void) {
+    long pages_total, pages_resident;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    int n = fscanf(f, "%ld %ld", &pages_total, &pages_resident);
+    fclose(f);
+    return n == 2 ? pages_resident * (sysconf(_SC_PAGESIZE) / 1024) : 0;
+}
+
+static void sleep_until(double target) {
+    double wait = target - omp_get_wtime();
+    if (wait <= 0) return;
+    struct timespec ts = { (time_t)wait, (long)((wait - (time_t)wait) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+// One epoch of the mixed workload; returns the ops completed
+static long long run_epoch(SkipList* list, SkipListOps* ops, SoakConfig* config, int epoch) {
+    long long completed = 0;
+    double end = omp_get_wtime() + config->interval;
+
+    #pragma omp parallel num_threads(config->threads) reduction(+:completed)
+    {
+        int tid = omp_get_thread_num();
+        unsigned int seed = (unsigned int)(epoch * 7919 + tid * 104729 + 1);
+        double start = omp_get_wtime();
+        long long i = 0;
+
+        while (true) {
+            // Check the clock every 256 ops to keep it off the hot path
+            if ((i & 255) == 0 && omp_get_wtime() >= end) break;
+            if (config->rate > 0) sleep_until(start + i / config->rate);
+
+            int op = rand_r(&seed) % 100;
+            int key = rand_r(&seed) % config->key_range;
+            if (op < config->insert_percent) {
+                ops->insert(list, key, key);
+            } else if (op < config->insert_percent + config->delete_percent) {
+                ops->delete(list, key);
+            } else {
+                ops->contains(list, key);
+            }
+            i++;
+        }
+        completed += i;
+    }
+    return completed;
+}
+
+// Quiescent checks and measurements after an epoch
+static void check_epoch(SkipList* list, int threads, MemoryStats* baseline, Epoch* e) {
+    SkipListStats stats;
+    ValidationReport report;
+    MemoryStats mem;
+    skiplist_stats(list, &stats);
+    skiplist_memory_stats(&mem);
+
+    uint64_t outstanding = (mem.nodes_allocated - baseline->nodes_allocated) -
+                           (mem.nodes_freed - baseline->nodes_freed);
+
+    e->valid = validate_skiplist_parallel(list, threads, &report);
+    if (!e->valid) {
+        print_validation_report(&report);
+    }
+    e->rss_kb = current_rss_kb();
+    e->node_mb = outstanding * NODE_FOOTPRINT / (1024.0 * 1024.0);
+    e->other_rss_mb = e->rss_kb / 1024.0 - e->node_mb;
+    e->live = stats.keys;
+    e->retired = (long long)outstanding - stats.keys - 2;  // Minus head/tail sentinels
+    e->avg_path = stats.avg_path_length;
+}
+
+static double window_mean(int first, int count, size_t offset) {
+    double sum = 0.0;
+    for (int i = first; i < first + count; i++) {
+        sum += *(double*)((char*)&epochs[i] + offset);
+    }
+    return sum / count;
+}
+
+// Relative change (percent) between the first and last TREND_WINDOW epochs
+// after the warm-up epoch
+static double drift(int num_epochs, size_t offset) {
+    int usable = num_epochs - 1;
+    int window = usable < 2 * TREND_WINDOW ? usable / 2 : TREND_WINDOW;
+    if (window < 1) return 0.0;
+    double first = window_mean(1, window, offset);
+    double last = window_mean(num_epochs - window, window, offset);
+    return first != 0.0 ? 100.0 * (last - first) / first : 0.0;
+}
+
+static bool soak(SoakConfig* config) {
+    SkipListOps ops;
+    if (!get_ops(config->impl, &ops)) {
+        fprintf(stderr, "Unknown implementation: %s\n", config->impl);
+        return false;
+    }
+
+    FILE* trend = NULL;
+    if (config->trend_path) {
+        trend = fopen(config->trend_path, "a");
+        if (!trend) {
+            perror("Failed to open trend file");
+            return false;
+        }
+        if (ftell(trend) == 0) {
+            fprintf(trend, "impl,epoch,elapsed_s,ops,throughput,rss_kb,node_mb,other_rss_mb,"
+                           "live,retired,avg_path,valid\n");
+        }
+    }
+
+    int num_epochs = (int)(config->duration / config->interval + 0.5);
+    if (num_epochs < 1) num_epochs = 1;
+    if (num_epochs > MAX_EPOCHS) num_epochs = MAX_EPOCHS;
+
+    printf("\n=== Soak: %s, %d threads, %.0fs in %d epochs, key range %d, %d/%d/%d ===\n",
+           config->impl, config->threads, config->duration, num_epochs, config->key_range,
+           config->insert_percent, config->delete_percent,
+           100 - config->insert_percent - config->delete_percent);
+    printf("%6s %9s %13s %9s %9s %10s %10s %11s %9s %6s\n", "epoch", "elapsed", "ops/sec", "RSS(MB)",
+           "nodes(MB)", "other(MB)", "live", "retired", "avg path", "valid");
+
+    MemoryStats baseline;
+    skiplist_memory_stats(&baseline);
+    SkipList* list = ops.create();
+    double start = omp_get_wtime();
+    bool valid = true;
+
+    for (int n = 0; n < num_epochs; n++) {
+        Epoch* e = &epochs[n];
+        double epoch_start = omp_get_wtime();
+        e->ops = run_epoch(list, &ops, config, n);
+        e->throughput = e->ops / (omp_get_wtime() - epoch_start);
+        e->elapsed = omp_get_wtime() - start;
+        check_epoch(list, config->threads, &baseline, e);
+        valid = valid && e->valid;
+
+        printf("%6d %8.1fs %13.0f %9.1f %9.1f %10.1f %10d %11lld %9.2f %6s\n", n, e->elapsed,
+               e->throughput, e->rss_kb / 1024.0, e->node_mb, e->other_rss_mb, e->live,
+               e->retired, e->avg_path, e->valid ? "yes" : "NO");
+        fflush(stdout);
+        if (trend) {
+            fprintf(trend, "%s,%d,%.2f,%lld,%.1f,%ld,%.2f,%.2f,%d,%lld,%.3f,%d\n", config->impl, n,
+                    e->elapsed, e->ops, e->throughput, e->rss_kb, e->node_mb, e->other_rss_mb,
+                    e->live, e->retired, e->avg_path, e->valid);
+            fflush(trend);
+        }
+        if (!e->valid) {  // No point soaking a corrupted list
+            num_epochs = n + 1;
+            break;
+        }
+        if (config->max_rss_mb > 0 && e->rss_kb / 1024.0 > config->max_rss_mb) {
+            num_epochs = n + 1;
+            break;
+        }
+    }
+    ops.destroy(list);
+    if (trend) fclose(trend);
+
+    double throughput_drift = drift(num_epochs, offsetof(Epoch, throughput));
+    double path_drift = drift(num_epochs, offsetof(Epoch, avg_path));
+    double other_rss_first = epochs[num_epochs > 1 ? 1 : 0].other_rss_mb;
+    double other_rss_growth = epochs[num_epochs - 1].other_rss_mb - other_rss_first;
+    double reference_rss = epochs[num_epochs > 1 ? 1 : 0].rss_kb / 1024.0;
+    double rss_drift = reference_rss > 0 ? 100.0 * other_rss_growth / reference_rss : 0.0;
+    double final_rss = epochs[num_epochs - 1].rss_kb / 1024.0;
+
+    bool throughput_ok = throughput_drift >= -config->max_throughput_drift;
+    bool path_ok = path_drift <= config->max_path_drift;
+    bool rss_ok = rss_drift <= config->max_rss_drift;
+    bool cap_ok = config->max_rss_mb <= 0 || final_rss <= config->max_rss_mb;
+
+    printf("Validation:        %s\n", valid ? "ok" : "FAILED");
+    printf("Throughput drift:  %+.1f%% (limit -%.0f%%) %s\n", throughput_drift,
+           config->max_throughput_drift, throughput_ok ? "ok" : "FAILED");
+    printf("Search path drift: %+.1f%% (limit +%.0f%%) %s\n", path_drift,
+           config->max_path_drift, path_ok ? "ok" : "FAILED");
+    printf("Non-node RSS:      %+.1f MB, %+.1f%% of RSS (limit +%.0f%%) %s\n", other_rss_growth,
+           rss_drift, config->max_rss_drift, rss_ok ? "ok" : "FAILED");
+    printf("Retired nodes:     %lld (%.1f MB, never freed by design in fine/lockfree)\n",
+           epochs[num_epochs - 1].retired, epochs[num_epochs - 1].retired * NODE_FOOTPRINT / (1024.0 * 1024.0));
+    if (config->max_rss_mb > 0) {
+        printf("RSS cap:           %.1f MB (limit %.0f MB) %s\n", final_rss, config->max_rss_mb,
+               cap_ok ? "ok" : "FAILED");
+    }
+
+    return valid && throughput_ok && path_ok && rss_ok && cap_ok;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [OPTIONS]\n", prog);
+    printf("Options:\n");
+    printf("  --impl <type>          coarse, fine, lockfree or all (default: all)\n");
+    printf("  --duration <sec>       Soak time per implementation (default: 60)\n");
+    printf("  --interval <sec>       Epoch length between checks (default: 5)\n");
+    printf("  --threads <n>          Worker threads (default: 4)\n");
+    printf("  --key-range <n>        Range of keys (default: 10000)\n");
+    printf("  --insert-pct <n>       Insert percentage (default: 30)\n");
+    printf("  --delete-pct <n>       Delete percentage (default: 20)\n");
+    printf("  --rate <ops/sec>       Throttle each thread (default: unthrottled)\n");
+    printf("  --max-throughput-drift <pct>  Allowed throughput drop (default: 20)\n");
+    printf("  --max-path-drift <pct>        Allowed search path growth (default: 25)\n");
+    printf("  --max-rss-drift <pct>         Allowed non-node RSS growth (default: 25)\n");
+    printf("  --max-rss-mb <mb>             Absolute RSS cap (default: off)\n");
+    printf("  --trend <file>         Append per-epoch rows to a CSV file\n");
+    printf("  --help                 Show this help message\n");
+}
+
+int main(int argc, char* argv[]) {
+    SoakConfig config = {
+        .impl = "all",
+        .duration = 60.0,
+        .interval = 5.0,
+        .threads = 4,
+        .key_range = 10000,
+        .insert_percent = 30,
+        .delete_percent = 20,
+        .rate = 0.0,
+        .max_throughput_drift = 20.0,
+        .max_path_drift = 25.0,
+        .max_rss_drift = 25.0,
+        .max_rss_mb = 0.0,
+        .trend_path = NULL
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--impl") == 0 && i + 1 < argc) {
+            snprintf(config.impl, sizeof(config.impl), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            config.duration = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            config.interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--key-range") == 0 && i + 1 < argc) {
+            config.key_range = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--insert-pct") == 0 && i + 1 < argc) {
+            config.insert_percent = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--delete-pct") == 0 && i + 1 < argc) {
+            config.delete_percent = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            config.rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-throughput-drift") == 0 && i + 1 < argc) {
+            config.max_throughput_drift = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-path-drift") == 0 && i + 1 < argc) {
+            config.max_path_drift = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-rss-drift") == 0 && i + 1 < argc) {
+            config.max_rss_drift = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-rss-mb") == 0 && i + 1 < argc) {
+            config.max_rss_mb = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--trend") == 0 && i + 1 < argc) {
+            config.trend_path = argv[++i];
+        } else if (strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+
+    if (config.interval <= 0 || config.duration <= 0 || config.threads < 1 || config.key_range < 1) {
+        fprintf(stderr, "--duration, --interval, --threads and --key-range must be positive\n");
+        return 1;
+    }
+
+    const char* impls[] = { "coarse", "fine", "lockfree" };
+    int failures = 0;
+
+    if (strcmp(config.impl, "all") == 0) {
+        for (int i = 0; i < 3; i++) {
+            snprintf(config.impl, sizeof(config.impl), "%s", impls[i]);
+            if (!soak(&config)) failures++;
+        }
+    } else if (!soak(&config)) {
+        failures++;
+    }
+
+    printf("\n%s\n", failures == 0 ? "Soak test PASSED ✓" : "Soak test FAILED ✗");
+    return failures == 0 ? 0 : 1;
+}